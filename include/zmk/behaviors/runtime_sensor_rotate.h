@@ -10,14 +10,26 @@
 #include <zmk/keymap.h>
 #include <zmk/sensors.h>
 
-#define ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS ZMK_KEYMAP_LAYERS_LEN
-#define ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS ZMK_KEYMAP_SENSORS_LEN
+// Sensors and layers with runtime configuration, the first ones of the keymap. The others play
+// their devicetree bindings.
+#define ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS                                                       \
+    MIN(CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_RUNTIME_LAYERS, ZMK_KEYMAP_LAYERS_LEN)
+#define ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS                                                      \
+    MIN(CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_RUNTIME_SENSORS, ZMK_KEYMAP_SENSORS_LEN)
+#define ZMK_RUNTIME_SENSOR_ROTATE_MAX_CHANNELS CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_MAX_CHANNELS
+#define ZMK_RUNTIME_SENSOR_ROTATE_PROFILES CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_PROFILES
 
+// Ordered so that it packs without padding. Also the layout stored in settings.
 struct runtime_sensor_rotate_binding {
     zmk_behavior_local_id_t behavior_local_id;
+    uint16_t tap_ms;
+    // Full width, keycodes carry implicit modifiers in the upper bits
     uint32_t param1;
     uint32_t param2;
-    uint32_t tap_ms;
+    // Hold mode when non-zero: the first trigger presses the binding, which stays held until no
+    // trigger in the same direction arrived for this long. 0 taps once per trigger.
+    uint16_t hold_ms;
+    uint16_t reserved;
 };
 
 struct runtime_sensor_rotate_layer_bindings {
@@ -26,24 +38,251 @@ struct runtime_sensor_rotate_layer_bindings {
 };
 
 /**
- * Get the layer bindings for a specific sensor and layer
+ * Acceleration curve applied to the trigger count of a sensor event.
+ *
+ * When the time since the previous event of the sensor is below threshold_ms, the trigger count
+ * is scaled by a factor that rises linearly from 100% at threshold_ms to multiplier% at 0ms.
+ */
+struct runtime_sensor_rotate_acceleration {
+    // 0 disables acceleration
+    uint16_t threshold_ms;
+    // Scale factor in percent for back-to-back events
+    uint16_t multiplier;
+    // Maximum triggers per event after scaling, 0 for no limit
+    uint16_t max_triggers;
+};
+
+enum runtime_sensor_rotate_update_type {
+    RUNTIME_SENSOR_ROTATE_UPDATE_CW_BINDING,
+    RUNTIME_SENSOR_ROTATE_UPDATE_CCW_BINDING,
+    RUNTIME_SENSOR_ROTATE_UPDATE_ACCELERATION,
+};
+
+// One change of a batch passed to zmk_runtime_sensor_rotate_apply_updates
+struct runtime_sensor_rotate_update {
+    uint8_t sensor_index;
+    // Channel of the sensor events, 0 for single-channel sensors
+    uint8_t channel;
+    uint8_t layer;
+    enum runtime_sensor_rotate_update_type type;
+    union {
+        struct runtime_sensor_rotate_binding binding;
+        struct runtime_sensor_rotate_acceleration acceleration;
+    };
+};
+
+#if IS_ENABLED(CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_STATS)
+
+// Counters of a sensor/layer since boot or the last reset
+struct runtime_sensor_rotate_stats {
+    // Sensor events seen by the layer, whether active or not
+    uint32_t events_accepted;
+    // Taps emitted per direction, after acceleration
+    uint32_t cw_triggers;
+    uint32_t ccw_triggers;
+    // Events with triggers that fell through to lower layers
+    uint32_t transparent;
+    // Events whose runtime binding couldn't be resolved to a behavior
+    uint32_t lookup_failures;
+    uint32_t max_triggers_per_event;
+    // Time spent handling events with triggers on the active layer, in cycles
+    uint32_t process_count;
+    uint32_t process_cycles_max;
+    uint64_t process_cycles_total;
+    // Events played back as taps through the behavior queue, and those of them whose tap-ms was
+    // shortened to meet the latency bound of the sensor
+    uint32_t tap_bursts;
+    uint32_t shortened_events;
+    // tap-ms used for the last and the shortest burst of taps, 0 before any
+    uint16_t last_tap_ms;
+    uint16_t min_tap_ms;
+};
+
+/**
+ * Get the counters of a specific sensor and layer
+ */
+int zmk_runtime_sensor_rotate_get_stats(uint8_t sensor_index, uint8_t layer,
+                                        struct runtime_sensor_rotate_stats *out);
+
+/**
+ * Reset the counters of all sensors and layers
+ */
+void zmk_runtime_sensor_rotate_reset_stats(void);
+
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_EVENT_LOG)
+
+// A sensor channel event as handled by one layer, recorded with
+// CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_EVENT_LOG
+struct runtime_sensor_rotate_event_record {
+    uint32_t sequence;
+    // Uptime of the event, truncated
+    uint32_t timestamp_ms;
+    // Rotation reported by the sensor
+    int32_t val1;
+    int32_t val2;
+    // Rotation left in the accumulator of the layer, in thousandths of a trigger
+    int32_t remainder_milli;
+    // After acceleration, positive for CW. 0 when the rotation stayed below a trigger.
+    int16_t triggers;
+    uint8_t sensor_index;
+    uint8_t channel;
+    uint8_t layer;
+    // The layer had no binding for the direction and the event fell through it
+    bool transparent;
+    // Binding played, if any
+    struct runtime_sensor_rotate_binding binding;
+};
+
+/**
+ * Copy up to max_count recorded events, oldest first, starting at sequence number since, and
+ * keep recording for a few seconds. Events are only recorded while a client keeps draining them.
+ * Returns the number of events copied and sets next_sequence to pass to the next call, and
+ * dropped to the number of events since then that were overwritten before being read.
+ */
+int zmk_runtime_sensor_rotate_drain_events(uint32_t since,
+                                           struct runtime_sensor_rotate_event_record *out,
+                                           size_t max_count, uint32_t *next_sequence,
+                                           uint32_t *dropped);
+
+#endif
+
+/**
+ * Get the active binding profile. The bindings and acceleration of all getters and setters below
+ * are those of the active profile, resolution and maximum latency are shared by all profiles.
+ */
+uint8_t zmk_runtime_sensor_rotate_get_active_profile(void);
+
+/**
+ * Switch the active binding profile. Takes effect on the next sensor event, the index is saved
+ * once it stayed the same for CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_PROFILE_SAVE_DELAY_MS.
+ */
+int zmk_runtime_sensor_rotate_set_active_profile(uint8_t profile);
+
+/**
+ * Get the runtime layer bindings for a specific sensor and layer, channel 0
  */
 int zmk_runtime_sensor_rotate_get_layer_bindings(
     uint8_t sensor_index, uint8_t layer, struct runtime_sensor_rotate_layer_bindings *bindings);
 
 /**
- * Set the layer bindings for a specific sensor and layer
+ * Set the layer bindings for a specific sensor and layer, channel 0
  */
 int zmk_runtime_sensor_rotate_set_layer_bindings(
     uint8_t sensor_index, uint8_t layer,
     const struct runtime_sensor_rotate_layer_bindings *bindings);
 
 /**
- * Get the layer bindings for a specific sensor and layer
+ * Get the effective layer bindings for a specific sensor, channel and layer, with the devicetree
+ * defaults filled in where there is no runtime binding
+ */
+int zmk_runtime_sensor_rotate_get_channel_bindings(
+    uint8_t sensor_index, uint8_t channel, uint8_t layer_index,
+    struct runtime_sensor_rotate_layer_bindings *out);
+
+/**
+ * Get the effective layer bindings for a specific sensor and layer, channel 0
  */
 int zmk_runtime_sensor_rotate_get_bindings(uint8_t sensor_index, uint8_t layer_index,
                                            struct runtime_sensor_rotate_layer_bindings *out);
 
+/**
+ * Get the acceleration curve for a specific sensor, channel and layer
+ */
+int zmk_runtime_sensor_rotate_get_channel_acceleration(
+    uint8_t sensor_index, uint8_t channel, uint8_t layer,
+    struct runtime_sensor_rotate_acceleration *out);
+
+/**
+ * Get the acceleration curve for a specific sensor and layer, channel 0
+ */
+int zmk_runtime_sensor_rotate_get_acceleration(uint8_t sensor_index, uint8_t layer,
+                                               struct runtime_sensor_rotate_acceleration *out);
+
+/**
+ * Set the acceleration curve for a specific sensor and layer, channel 0. Other channels are
+ * changed through zmk_runtime_sensor_rotate_apply_updates.
+ */
+int zmk_runtime_sensor_rotate_set_acceleration(
+    uint8_t sensor_index, uint8_t layer, const struct runtime_sensor_rotate_acceleration *accel);
+
+// Bounds of the resolution of a sensor, in percent of its triggers per rotation
+#define ZMK_RUNTIME_SENSOR_ROTATE_MIN_RESOLUTION 1
+#define ZMK_RUNTIME_SENSOR_ROTATE_MAX_RESOLUTION 1000
+
+/**
+ * Get the resolution of a sensor in percent of the triggers per rotation of the keymap, 100 by
+ * default. Applies to all layers.
+ */
+uint16_t zmk_runtime_sensor_rotate_get_resolution(uint8_t sensor_index);
+
+/**
+ * Set the resolution of a sensor in percent of the triggers per rotation of the keymap. Saved
+ * with the binding changes, see zmk_runtime_sensor_rotate_save_changes.
+ */
+int zmk_runtime_sensor_rotate_set_resolution(uint8_t sensor_index, uint16_t percent);
+
+/**
+ * Get the maximum time in ms to play back the taps of one event of a sensor, 0 for no bound
+ */
+uint16_t zmk_runtime_sensor_rotate_get_max_latency(uint8_t sensor_index);
+
+/**
+ * Set the maximum time in ms to play back the taps of one event of a sensor, 0 for no bound.
+ * Saved with the binding changes, see zmk_runtime_sensor_rotate_save_changes.
+ */
+int zmk_runtime_sensor_rotate_set_max_latency(uint8_t sensor_index, uint16_t max_latency_ms);
+
+/**
+ * Apply a batch of binding and acceleration changes. Either all of them are applied and saved
+ * together, or none is applied if any is invalid or there aren't enough free override slots.
+ */
+int zmk_runtime_sensor_rotate_apply_updates(const struct runtime_sensor_rotate_update *updates,
+                                            size_t count);
+
+/**
+ * Export the runtime configuration of all profiles and sensors as a versioned, checksummed blob.
+ * Behaviors are referenced by name rather than local ID, so that the blob can be imported into
+ * another build. Returns the size of the blob, or -ENOMEM if it doesn't fit into size.
+ */
+int zmk_runtime_sensor_rotate_export_config(uint8_t *buf, size_t size);
+
+/**
+ * Replace the runtime configuration of all profiles and sensors with a blob exported by
+ * zmk_runtime_sensor_rotate_export_config. The whole blob is validated first, and nothing
+ * changes if it is corrupt, names a behavior this build doesn't have or configures sensor/layers
+ * without runtime configuration here. The result is saved in a single pass.
+ */
+int zmk_runtime_sensor_rotate_import_config(const uint8_t *buf, size_t len);
+
+/**
+ * Get the generation of the runtime configuration of a sensor. It changes whenever the
+ * configuration of the sensor changes, including when it's reloaded from settings.
+ */
+uint32_t zmk_runtime_sensor_rotate_get_generation(uint8_t sensor_index);
+
+/**
+ * Get the generation of the runtime configuration of all sensors. It changes once per change,
+ * or batch of changes applied by zmk_runtime_sensor_rotate_apply_updates.
+ */
+uint32_t zmk_runtime_sensor_rotate_get_global_generation(void);
+
+/**
+ * Save all changes that are still waiting for the save debounce period
+ */
+int zmk_runtime_sensor_rotate_save_changes(void);
+
+/**
+ * Drop all changes that are not saved yet and reload the saved configuration
+ */
+int zmk_runtime_sensor_rotate_discard_changes(void);
+
+/**
+ * Whether there are changes that are not saved yet
+ */
+bool zmk_runtime_sensor_rotate_has_unsaved_changes(void);
+
 /**
  * Get all layer bindings for a specific sensor
  */
@@ -11,6 +11,9 @@
 #include <zephyr/logging/log.h>
 #include <zephyr/kernel.h>
 #include <zephyr/settings/settings.h>
+#include <zephyr/random/random.h>
+#include <zephyr/sys/barrier.h>
+#include <zephyr/sys/crc.h>
 
 #include <drivers/behavior.h>
 #include <zmk/behavior.h>
@@ -18,134 +21,2150 @@
 #include <zmk/sensors.h>
 #include <zmk/behavior_queue.h>
 #include <zmk/virtual_key_position.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/layer_state_changed.h>
 #include <zmk/events/position_state_changed.h>
 #include <zmk/behaviors/runtime_sensor_rotate.h>
 
 #include <string.h>
 
+#include "runtime_sensor_rotate_accumulator.h"
+#include "runtime_sensor_rotate_test.h"
+
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 struct behavior_runtime_sensor_rotate_config {
+    uint8_t index;
     const char *default_cw_binding_name;
     const char *default_ccw_binding_name;
     struct runtime_sensor_rotate_binding default_cw_binding_params;
     struct runtime_sensor_rotate_binding default_ccw_binding_params;
+    bool coalesce;
+    uint16_t coalesce_max_pending;
+};
+
+// Binding with the behavior name and local ID already looked up, so that the trigger path only
+// has to index into the table.
+struct runtime_sensor_rotate_resolved_binding {
+    const char *behavior_dev;
+    uint32_t param1;
+    uint32_t param2;
+    zmk_behavior_local_id_t behavior_local_id;
+    uint16_t tap_ms;
+    uint16_t hold_ms;
+    // Unset, unresolvable or bound to &trans
+    bool transparent;
+};
+
+struct runtime_sensor_rotate_resolved_layer_bindings {
+    struct runtime_sensor_rotate_resolved_binding cw_binding;
+    struct runtime_sensor_rotate_resolved_binding ccw_binding;
+    // Config of the behavior instance bound in the keymap, NULL if none
+    const struct behavior_runtime_sensor_rotate_config *config;
+    bool valid;
+};
+
+// Runtime configuration of a sensor channel/layer in a profile. Only sensor channel/layers which
+// differ from the devicetree defaults occupy one of these. Only accessed with config_lock held,
+// the sensor event path reads the published snapshot of the slot instead.
+struct runtime_sensor_rotate_override {
+    struct runtime_sensor_rotate_layer_bindings bindings;
+    struct runtime_sensor_rotate_acceleration acceleration;
+    uint8_t profile;
+    uint8_t sensor_index;
+    uint8_t channel;
+    uint8_t layer;
+    bool in_use;
+};
+
+// Everything the sensor event path needs of an override slot
+struct runtime_sensor_rotate_snapshot {
+    struct runtime_sensor_rotate_resolved_layer_bindings resolved;
+    struct runtime_sensor_rotate_acceleration acceleration;
+    // Profile and sensor channel/layer the slot belonged to when published
+    uint8_t profile;
+    uint8_t sensor_index;
+    uint8_t channel;
+    uint8_t layer;
+    bool in_use;
+};
+
+// Two copies of the snapshot of an override slot. Readers use copies[seq & 1] and retry if seq
+// changed meanwhile. The writer bumps seq before updating a copy, so that readers are always
+// steered to the other, complete one and never have to wait for the writer. Unlike a plain
+// seqlock this can't livelock a reader that preempted the writer in the middle of an update.
+struct runtime_sensor_rotate_latch {
+    atomic_t seq;
+    struct runtime_sensor_rotate_snapshot copies[2];
+};
+
+// Per-sensor channel state of coalesce mode. Triggers are merged into a signed pending count
+// which is played back by a single work item, instead of queueing a press/release pair per
+// trigger.
+struct runtime_sensor_rotate_coalesce_state {
+    struct k_work_delayable work;
+    struct k_spinlock lock;
+    // Remaining taps; positive for CW, negative for CCW
+    int pending;
+    struct runtime_sensor_rotate_resolved_binding pending_binding;
+    struct zmk_behavior_binding_event pending_event;
+    // Binding currently pressed by the work item, released on its next run
+    struct runtime_sensor_rotate_resolved_binding active_binding;
+    struct zmk_behavior_binding_event active_event;
+    // Uptime at which the pressed binding is due for release, tap-ms after the press
+    int64_t release_at;
+    bool pressed;
+};
+
+// Per-sensor channel state of hold mode. The binding stays pressed while triggers in the same
+// direction keep arriving, and the work item releases it once they stop. The lock only guards the
+// state, the behavior queue is called after releasing it as it may invoke the binding right away.
+struct runtime_sensor_rotate_hold_state {
+    struct k_work_delayable work;
+    struct k_spinlock lock;
+    struct runtime_sensor_rotate_resolved_binding binding;
+    struct zmk_behavior_binding_event event;
+    // Extended by each trigger, the work item reschedules itself until then
+    int64_t release_at;
+    // 1 for CW, -1 for CCW, 0 while nothing is held
+    int8_t direction;
+};
+
+#define RUNTIME_SENSOR_ROTATE_INSTANCES DT_NUM_INST_STATUS_OKAY(DT_DRV_COMPAT)
+#define RUNTIME_SENSOR_ROTATE_MAX_OVERRIDES CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_MAX_OVERRIDES
+
+// Per-channel state is indexed by sensor channel, channel 0 of sensor s at s * MAX_CHANNELS. The
+// sensor event path keeps state for all sensors of the keymap, the runtime configuration only for
+// the first ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS.
+#define RUNTIME_SENSOR_ROTATE_SENSOR_CHANNELS                                                      \
+    (ZMK_KEYMAP_SENSORS_LEN * ZMK_RUNTIME_SENSOR_ROTATE_MAX_CHANNELS)
+#define RUNTIME_SENSOR_ROTATE_CONFIG_SENSOR_CHANNELS                                               \
+    (ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS * ZMK_RUNTIME_SENSOR_ROTATE_MAX_CHANNELS)
+#define SENSOR_CHANNEL(sensor_index, channel)                                                      \
+    ((sensor_index) * ZMK_RUNTIME_SENSOR_ROTATE_MAX_CHANNELS + (channel))
+
+// Index into the dirty and needs_migration bitmaps
+#define SETTINGS_BIT(profile, sensor_index, channel, layer)                                        \
+    (((profile) * RUNTIME_SENSOR_ROTATE_CONFIG_SENSOR_CHANNELS +                                   \
+      SENSOR_CHANNEL(sensor_index, channel)) *                                                     \
+         ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS +                                                    \
+     (layer))
+#define SETTINGS_BITS                                                                              \
+    (ZMK_RUNTIME_SENSOR_ROTATE_PROFILES * RUNTIME_SENSOR_ROTATE_CONFIG_SENSOR_CHANNELS *           \
+     ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS)
+
+// Layer whose binding plays the triggers of a sensor channel in one direction for the current
+// layer state, see get_effective_layer. Valid while epoch matches effective_epoch.
+struct runtime_sensor_rotate_effective_layer {
+    uint32_t epoch;
+    int8_t layer;
+    bool valid;
+};
+
+// No active layer has a non-transparent binding for the direction
+#define EFFECTIVE_LAYER_NONE -1
+// The triggers fall through to a layer bound to another behavior, which ZMK has to reach
+#define EFFECTIVE_LAYER_OTHER -2
+
+// Rotation of a sensor channel between accept_data and process. Only the layer playing the
+// rotation accumulates it, see get_effective_layer, so it is kept per sensor channel rather than
+// per layer.
+struct runtime_sensor_rotate_channel_state {
+    // Rotation not yet turned into triggers, see runtime_sensor_rotate_accumulator.h
+    int64_t remainder;
+    // Triggers of the current event for layer, or for every layer when it is EFFECTIVE_LAYER_OTHER
+    // as they are all transparent then
+    int16_t triggers;
+    int8_t layer;
+    // Triggers of layer taken and not processed yet, a repeated accept_data doesn't add them again
+    bool accepted;
+    // Direction of the rotation of the current event
+    int8_t direction;
 };
 
 struct behavior_runtime_sensor_rotate_data {
-    struct sensor_value remainder[ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS][ZMK_KEYMAP_LAYERS_LEN];
-    int triggers[ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS][ZMK_KEYMAP_LAYERS_LEN];
-    struct runtime_sensor_rotate_layer_bindings bindings[ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS]
-                                                        [ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS];
-    bool data_accepted[ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS][ZMK_KEYMAP_LAYERS_LEN];
+    struct runtime_sensor_rotate_channel_state channels[RUNTIME_SENSOR_ROTATE_SENSOR_CHANNELS];
+    // 1-based index into defaults of the instance bound in the keymap, 0 if none
+    uint8_t default_slot[ZMK_KEYMAP_SENSORS_LEN][ZMK_KEYMAP_LAYERS_LEN];
+    // 1-based index into overrides per profile, 0 if the sensor channel/layer uses the defaults
+    uint8_t override_slot[ZMK_RUNTIME_SENSOR_ROTATE_PROFILES]
+                         [RUNTIME_SENSOR_ROTATE_CONFIG_SENSOR_CHANNELS]
+                         [ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS];
+    // Profile whose overrides the sensor event path and the RPC read and write
+    atomic_t active_profile;
+    // Active profile as last loaded from or written to settings
+    uint8_t saved_profile;
+    bool default_slots_initialized;
+    struct runtime_sensor_rotate_resolved_layer_bindings defaults[RUNTIME_SENSOR_ROTATE_INSTANCES];
+    struct runtime_sensor_rotate_override overrides[RUNTIME_SENSOR_ROTATE_MAX_OVERRIDES];
+    struct runtime_sensor_rotate_latch published[RUNTIME_SENSOR_ROTATE_MAX_OVERRIDES];
+    // Sensor channel/layers changed since the last save, see SETTINGS_BIT
+    ATOMIC_DEFINE(dirty, SETTINGS_BITS);
+    // Sensor channel/layers loaded from an older format or the other settings layout, to be
+    // rewritten
+    ATOMIC_DEFINE(needs_migration, SETTINGS_BITS);
+    // Sensors whose resolution or maximum latency is to be written by the next save
+    ATOMIC_DEFINE(tuning_dirty, ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS);
+    // Fraction of a trigger left over by acceleration scaling, in percent
+    int16_t acceleration_remainder[RUNTIME_SENSOR_ROTATE_CONFIG_SENSOR_CHANNELS]
+                                  [ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS];
+    // Percent of the triggers per rotation of the keymap, 0 for the default of 100
+    uint16_t resolution[ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS];
+    // Maximum time to play back the taps of one event, the Kconfig default unless set
+    uint16_t max_latency_ms[ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS];
+    bool max_latency_set[ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS];
+    int64_t last_event_timestamp[ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS];
+    uint32_t event_interval_ms[ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS];
+    struct runtime_sensor_rotate_coalesce_state coalesce[RUNTIME_SENSOR_ROTATE_SENSOR_CHANNELS];
+    struct runtime_sensor_rotate_hold_state hold[RUNTIME_SENSOR_ROTATE_SENSOR_CHANNELS];
+    // Per direction, CW first. Bumping effective_epoch invalidates all of them.
+    struct runtime_sensor_rotate_effective_layer effective[RUNTIME_SENSOR_ROTATE_SENSOR_CHANNELS]
+                                                          [2];
+    atomic_t effective_epoch;
+    // Keymap layout the cached effective layers were found with. Studio reorders layers and
+    // changes the default layer without raising a layer state change.
+    zmk_keymap_layer_id_t effective_default_layer;
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
+    zmk_keymap_layer_id_t effective_layer_order[ZMK_KEYMAP_LAYERS_LEN];
+#endif
+    // Set once the sensor event path asked for a republish of unresolved bindings, cleared by the
+    // next publish from the writer side
+    atomic_t republish_requested;
+    // Bumped by every change of the runtime configuration of a sensor, and of any sensor
+    atomic_t generation[ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS];
+    atomic_t global_generation;
+    atomic_t generations_seeded;
+#if IS_ENABLED(CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_STATS)
+    struct runtime_sensor_rotate_stats stats[ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS]
+                                            [ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS];
+    // Shared by the sensor/layers without runtime configuration, not reported
+    struct runtime_sensor_rotate_stats untracked_stats;
+#endif
 };
 
+BUILD_ASSERT(RUNTIME_SENSOR_ROTATE_MAX_OVERRIDES < UINT8_MAX);
+BUILD_ASSERT(RUNTIME_SENSOR_ROTATE_INSTANCES < UINT8_MAX);
+
 static struct behavior_runtime_sensor_rotate_data global_data = {};
 
+// Serializes changes of the runtime configuration and saving it. Never taken by the sensor event
+// path.
+static K_MUTEX_DEFINE(config_lock);
+
+// Generations start from a random value, so that one remembered by a client from before a
+// reboot is unlikely to match the reloaded configuration.
+static void seed_generations(void) {
+    if (!atomic_cas(&global_data.generations_seeded, 0, 1)) {
+        return;
+    }
+    uint32_t seed = sys_rand32_get() ^ k_cycle_get_32();
+    for (int i = 0; i < ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS; i++) {
+        atomic_set(&global_data.generation[i], seed);
+    }
+    atomic_set(&global_data.global_generation, seed);
+}
+
+static void bump_generation(uint8_t sensor_index) {
+    seed_generations();
+    atomic_inc(&global_data.generation[sensor_index]);
+}
+
+static void bump_global_generation(void) {
+    seed_generations();
+    atomic_inc(&global_data.global_generation);
+}
+
+uint32_t zmk_runtime_sensor_rotate_get_generation(uint8_t sensor_index) {
+    if (sensor_index >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS) {
+        return 0;
+    }
+    seed_generations();
+    return (uint32_t)atomic_get(&global_data.generation[sensor_index]);
+}
+
+uint32_t zmk_runtime_sensor_rotate_get_global_generation(void) {
+    seed_generations();
+    return (uint32_t)atomic_get(&global_data.global_generation);
+}
+
 #if ZMK_KEYMAP_HAS_SENSORS
 
-#define _TRANSFORM_SENSOR_ENTRY(idx, layer)                                                        \
-    COND_CODE_1(DT_NODE_HAS_COMPAT(DT_PHANDLE_BY_IDX(layer, sensor_bindings, idx),                 \
-                                   zmk_behavior_runtime_sensor_rotate),                            \
-                (DEVICE_DT_NAME(DT_PHANDLE_BY_IDX(layer, sensor_bindings, idx))), (NULL))
-
-#define SENSOR_LAYER(node)                                                                         \
-    COND_CODE_1(                                                                                   \
-        DT_NODE_HAS_PROP(node, sensor_bindings),                                                   \
-        ({LISTIFY(DT_PROP_LEN(node, sensor_bindings), _TRANSFORM_SENSOR_ENTRY, (, ), node)}),      \
-        ({}))
-
-// TODO: The dimension order here is [layer][sensor]. Different from global_data which is
-// [sensor][layer].
-static const char *global_default_behavior_dev[ZMK_KEYMAP_LAYERS_LEN][ZMK_KEYMAP_SENSORS_LEN] = {
-    DT_FOREACH_CHILD_SEP(DT_INST(0, zmk_keymap), SENSOR_LAYER, (, ))};
+#define _DEFAULT_BEHAVIOR_ENTRY(layer, idx)                                                        \
+    COND_CODE_1(DT_PROP_HAS_IDX(layer, sensor_bindings, idx),                                      \
+                (COND_CODE_1(DT_NODE_HAS_COMPAT(DT_PHANDLE_BY_IDX(layer, sensor_bindings, idx),    \
+                                                zmk_behavior_runtime_sensor_rotate),               \
+                             (DEVICE_DT_GET(DT_PHANDLE_BY_IDX(layer, sensor_bindings, idx))),      \
+                             (NULL))),                                                             \
+                (NULL))
+
+#define _DEFAULT_BEHAVIOR_SENSOR(idx, _)                                                           \
+    {DT_FOREACH_CHILD_SEP_VARGS(DT_INST(0, zmk_keymap), _DEFAULT_BEHAVIOR_ENTRY, (, ), idx)}
+
+// Instance of this behavior bound to each sensor/layer in the keymap, NULL if none. Laid out
+// [sensor][layer] like global_data, and referencing the devices directly so that no name has to
+// be looked up.
+static const struct device *const default_behaviors[ZMK_KEYMAP_SENSORS_LEN]
+                                                  [ZMK_KEYMAP_LAYERS_LEN] = {
+    LISTIFY(ZMK_KEYMAP_SENSORS_LEN, _DEFAULT_BEHAVIOR_SENSOR, (, ))};
+
+#define _SENSOR_BOUND_ENTRY(layer, idx) DT_PROP_HAS_IDX(layer, sensor_bindings, idx)
+
+#define _SENSOR_BOUND_SENSOR(idx, _)                                                               \
+    {DT_FOREACH_CHILD_SEP_VARGS(DT_INST(0, zmk_keymap), _SENSOR_BOUND_ENTRY, (, ), idx)}
+
+// Whether each sensor/layer has any sensor binding in the keymap, of this behavior or another
+static const bool sensor_bound[ZMK_KEYMAP_SENSORS_LEN][ZMK_KEYMAP_LAYERS_LEN] = {
+    LISTIFY(ZMK_KEYMAP_SENSORS_LEN, _SENSOR_BOUND_SENSOR, (, ))};
 #endif
 
+// Drop the cached effective layers, after a change of the layer state or of any binding
+static void invalidate_effective_layers(void) { atomic_inc(&global_data.effective_epoch); }
+
 // Settings storage key
 #define SETTINGS_KEY "rsr"
 
-static int settings_set(const char *name, size_t len, settings_read_cb read_cb, void *cb_arg) {
+// Version of the per-sensor/layer settings record. Version 1 stored a bare
+// runtime_sensor_rotate_layer_bindings with 32-bit fields, acceleration was version 1 as well
+// and stored under a separate "/accel" key. Version 2 had no hold_ms in bindings.
+#define SETTINGS_VERSION 3
+
+struct runtime_sensor_rotate_settings_record {
+    uint8_t version;
+    struct runtime_sensor_rotate_acceleration acceleration;
+    struct runtime_sensor_rotate_layer_bindings bindings;
+} __packed;
+
+struct runtime_sensor_rotate_binding_v1 {
+    zmk_behavior_local_id_t behavior_local_id;
+    uint32_t param1;
+    uint32_t param2;
+    uint32_t tap_ms;
+};
+
+struct runtime_sensor_rotate_layer_bindings_v1 {
+    struct runtime_sensor_rotate_binding_v1 cw_binding;
+    struct runtime_sensor_rotate_binding_v1 ccw_binding;
+};
+
+struct runtime_sensor_rotate_binding_v2 {
+    zmk_behavior_local_id_t behavior_local_id;
+    uint16_t tap_ms;
+    uint32_t param1;
+    uint32_t param2;
+};
+
+struct runtime_sensor_rotate_layer_bindings_v2 {
+    struct runtime_sensor_rotate_binding_v2 cw_binding;
+    struct runtime_sensor_rotate_binding_v2 ccw_binding;
+};
+
+struct runtime_sensor_rotate_settings_record_v2 {
+    uint8_t version;
+    struct runtime_sensor_rotate_acceleration acceleration;
+    struct runtime_sensor_rotate_layer_bindings_v2 bindings;
+} __packed;
+
+BUILD_ASSERT(sizeof(struct runtime_sensor_rotate_settings_record) !=
+                     sizeof(struct runtime_sensor_rotate_layer_bindings_v1) &&
+                 sizeof(struct runtime_sensor_rotate_settings_record) !=
+                     sizeof(struct runtime_sensor_rotate_settings_record_v2) &&
+                 sizeof(struct runtime_sensor_rotate_settings_record_v2) !=
+                     sizeof(struct runtime_sensor_rotate_layer_bindings_v1),
+             "Settings records must be distinguishable from older versions by size");
+
+// Version of the per-sensor settings record, which holds all overridden layers of a sensor
+// under a single "s<sensor_index>" key. Entries of version 1 had version 2 bindings.
+#define SENSOR_SETTINGS_VERSION 2
+
+struct runtime_sensor_rotate_sensor_settings_header {
+    uint8_t version;
+    uint8_t count;
+} __packed;
+
+struct runtime_sensor_rotate_sensor_settings_entry {
+    uint8_t layer;
+    struct runtime_sensor_rotate_acceleration acceleration;
+    struct runtime_sensor_rotate_layer_bindings bindings;
+} __packed;
+
+struct runtime_sensor_rotate_sensor_settings_entry_v1 {
+    uint8_t layer;
+    struct runtime_sensor_rotate_acceleration acceleration;
+    struct runtime_sensor_rotate_layer_bindings_v2 bindings;
+} __packed;
+
+// A sensor can't have more overridden layers than there are override slots
+#define SENSOR_SETTINGS_MAX_ENTRIES                                                                \
+    MIN(ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS, RUNTIME_SENSOR_ROTATE_MAX_OVERRIDES)
+
+struct runtime_sensor_rotate_sensor_settings_record {
+    struct runtime_sensor_rotate_sensor_settings_header header;
+    struct runtime_sensor_rotate_sensor_settings_entry entries[SENSOR_SETTINGS_MAX_ENTRIES];
+} __packed;
+
+static void publish_override(struct runtime_sensor_rotate_override *override);
+
+static inline uint8_t active_profile(void) {
+    return (uint8_t)atomic_get(&global_data.active_profile);
+}
+
+static struct runtime_sensor_rotate_override *find_override(uint8_t profile, uint8_t sensor_index,
+                                                           uint8_t channel, uint8_t layer) {
+    uint8_t slot =
+        global_data.override_slot[profile][SENSOR_CHANNEL(sensor_index, channel)][layer];
+    return slot ? &global_data.overrides[slot - 1] : NULL;
+}
+
+static struct runtime_sensor_rotate_override *
+find_or_alloc_override(uint8_t profile, uint8_t sensor_index, uint8_t channel, uint8_t layer) {
+    struct runtime_sensor_rotate_override *override =
+        find_override(profile, sensor_index, channel, layer);
+    if (override) {
+        return override;
+    }
+
+    for (int i = 0; i < RUNTIME_SENSOR_ROTATE_MAX_OVERRIDES; i++) {
+        override = &global_data.overrides[i];
+        if (!override->in_use) {
+            *override = (struct runtime_sensor_rotate_override){
+                .profile = profile,
+                .sensor_index = sensor_index,
+                .channel = channel,
+                .layer = layer,
+                .in_use = true,
+            };
+            global_data.override_slot[profile][SENSOR_CHANNEL(sensor_index, channel)][layer] =
+                i + 1;
+            return override;
+        }
+    }
+
+    LOG_ERR("No free override slot for profile %d sensor %d channel %d layer %d, increase "
+            "CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_MAX_OVERRIDES",
+            profile, sensor_index, channel, layer);
+    return NULL;
+}
+
+// Release the slot once nothing differs from the defaults anymore
+static void release_override_if_unused(struct runtime_sensor_rotate_override *override) {
+    if (override->bindings.cw_binding.behavior_local_id == 0 &&
+        override->bindings.ccw_binding.behavior_local_id == 0 &&
+        override->acceleration.threshold_ms == 0) {
+        global_data
+            .override_slot[override->profile]
+                          [SENSOR_CHANNEL(override->sensor_index, override->channel)]
+                          [override->layer] = 0;
+        override->in_use = false;
+        publish_override(override);
+    }
+}
+
+static void convert_binding_v1(const struct runtime_sensor_rotate_binding_v1 *v1,
+                               struct runtime_sensor_rotate_binding *out) {
+    *out = (struct runtime_sensor_rotate_binding){
+        .behavior_local_id = v1->behavior_local_id,
+        .tap_ms = MIN(v1->tap_ms, UINT16_MAX),
+        .param1 = v1->param1,
+        .param2 = v1->param2,
+    };
+}
+
+static void convert_binding_v2(const struct runtime_sensor_rotate_binding_v2 *v2,
+                               struct runtime_sensor_rotate_binding *out) {
+    *out = (struct runtime_sensor_rotate_binding){
+        .behavior_local_id = v2->behavior_local_id,
+        .tap_ms = v2->tap_ms,
+        .param1 = v2->param1,
+        .param2 = v2->param2,
+    };
+}
+
+static void convert_layer_bindings_v2(const struct runtime_sensor_rotate_layer_bindings_v2 *v2,
+                                      struct runtime_sensor_rotate_layer_bindings *out) {
+    convert_binding_v2(&v2->cw_binding, &out->cw_binding);
+    convert_binding_v2(&v2->ccw_binding, &out->ccw_binding);
+}
+
+static int load_override(struct runtime_sensor_rotate_override *override, const char *name,
+                         size_t len, settings_read_cb read_cb, void *cb_arg) {
     int rc;
-    int sensor_index, layer;
+    int bit = SETTINGS_BIT(override->profile, override->sensor_index, override->channel,
+                           override->layer);
 
-    // Parse key format: s<sensor_index>/l<layer>
-    // Example: "s0/l1" for sensor 0, layer 1
-    if (sscanf(name, "s%d/l%d", &sensor_index, &layer) == 2) {
-        if (sensor_index < 0 || sensor_index >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS) {
-            LOG_WRN("Invalid sensor index in settings: %d", sensor_index);
+    if (len == sizeof(struct runtime_sensor_rotate_settings_record)) {
+        struct runtime_sensor_rotate_settings_record record;
+        rc = read_cb(cb_arg, &record, sizeof(record));
+        if (rc < 0) {
+            return rc;
+        }
+        if (record.version != SETTINGS_VERSION) {
+            LOG_ERR("Unsupported settings version %d for %s", record.version, name);
+            return -EINVAL;
+        }
+        override->bindings = record.bindings;
+        override->acceleration = record.acceleration;
+        if (IS_ENABLED(CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_SETTINGS_PER_SENSOR)) {
+            atomic_set_bit(global_data.needs_migration, bit);
+        }
+    } else if (len == sizeof(struct runtime_sensor_rotate_settings_record_v2)) {
+        struct runtime_sensor_rotate_settings_record_v2 record;
+        rc = read_cb(cb_arg, &record, sizeof(record));
+        if (rc < 0) {
+            return rc;
+        }
+        if (record.version != 2) {
+            LOG_ERR("Unsupported settings version %d for %s", record.version, name);
             return -EINVAL;
         }
-        if (layer < 0 || layer >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS) {
-            LOG_WRN("Invalid layer in settings: %d", layer);
+        struct runtime_sensor_rotate_layer_bindings_v2 bindings = record.bindings;
+        convert_layer_bindings_v2(&bindings, &override->bindings);
+        override->acceleration = record.acceleration;
+        atomic_set_bit(global_data.needs_migration, bit);
+        LOG_INF("Migrating %s from settings version 2", name);
+    } else if (len == sizeof(struct runtime_sensor_rotate_layer_bindings_v1)) {
+        struct runtime_sensor_rotate_layer_bindings_v1 v1;
+        rc = read_cb(cb_arg, &v1, sizeof(v1));
+        if (rc < 0) {
+            return rc;
+        }
+        convert_binding_v1(&v1.cw_binding, &override->bindings.cw_binding);
+        convert_binding_v1(&v1.ccw_binding, &override->bindings.ccw_binding);
+        atomic_set_bit(global_data.needs_migration, bit);
+        LOG_INF("Migrating %s from settings version 1", name);
+    } else {
+        LOG_ERR("Invalid settings data size for %s: %d", name, len);
+        return -EINVAL;
+    }
+    return 0;
+}
+
+// Only accessed from the settings load, which isn't reentrant
+static struct runtime_sensor_rotate_sensor_settings_record sensor_settings_load_buffer;
+
+static int load_sensor_record(uint8_t profile, uint8_t sensor_index, uint8_t channel,
+                              const char *name, size_t len, settings_read_cb read_cb,
+                              void *cb_arg) {
+    struct runtime_sensor_rotate_sensor_settings_record *record = &sensor_settings_load_buffer;
+    const size_t header_size = sizeof(struct runtime_sensor_rotate_sensor_settings_header);
+
+    // Entries of version 1 are smaller, so the buffer fits those as well
+    if (len < header_size || len > sizeof(*record)) {
+        LOG_ERR("Invalid settings data size for %s: %d", name, len);
+        return -EINVAL;
+    }
+
+    int rc = read_cb(cb_arg, record, len);
+    if (rc < 0) {
+        LOG_ERR("Failed to read settings for %s: %d", name, rc);
+        return rc;
+    }
+
+    uint8_t version = record->header.version;
+    size_t entry_size;
+    if (version == SENSOR_SETTINGS_VERSION) {
+        entry_size = sizeof(struct runtime_sensor_rotate_sensor_settings_entry);
+    } else if (version == 1) {
+        entry_size = sizeof(struct runtime_sensor_rotate_sensor_settings_entry_v1);
+        LOG_INF("Migrating %s from settings version 1", name);
+    } else {
+        LOG_ERR("Unsupported settings version %d for %s", version, name);
+        return -EINVAL;
+    }
+    if ((len - header_size) % entry_size != 0 ||
+        record->header.count != (len - header_size) / entry_size) {
+        LOG_ERR("Settings entry count %d doesn't match size for %s", record->header.count, name);
+        return -EINVAL;
+    }
+
+    for (int i = 0; i < record->header.count; i++) {
+        struct runtime_sensor_rotate_sensor_settings_entry entry;
+        if (version == SENSOR_SETTINGS_VERSION) {
+            entry = record->entries[i];
+        } else {
+            const struct runtime_sensor_rotate_sensor_settings_entry_v1 *v1 =
+                (const struct runtime_sensor_rotate_sensor_settings_entry_v1 *)record->entries + i;
+            struct runtime_sensor_rotate_layer_bindings_v2 bindings = v1->bindings;
+            struct runtime_sensor_rotate_layer_bindings converted;
+            convert_layer_bindings_v2(&bindings, &converted);
+            entry = (struct runtime_sensor_rotate_sensor_settings_entry){
+                .layer = v1->layer,
+                .acceleration = v1->acceleration,
+                .bindings = converted,
+            };
+        }
+        if (entry.layer >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS) {
+            LOG_WRN("Invalid layer in settings for %s: %d", name, entry.layer);
+            continue;
+        }
+
+        struct runtime_sensor_rotate_override *override =
+            find_or_alloc_override(profile, sensor_index, channel, entry.layer);
+        if (!override) {
+            return -ENOMEM;
+        }
+        override->bindings = entry.bindings;
+        override->acceleration = entry.acceleration;
+        publish_override(override);
+        if (IS_ENABLED(CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_SETTINGS_PER_LAYER) ||
+            version != SENSOR_SETTINGS_VERSION) {
+            atomic_set_bit(global_data.needs_migration,
+                           SETTINGS_BIT(profile, sensor_index, channel, entry.layer));
+        }
+    }
+
+    LOG_DBG("Loaded %s with %d layers", name, record->header.count);
+    return 0;
+}
+
+// Read one of the uint16_t values kept per sensor under their own key
+static int load_sensor_value(const char *name, size_t len, settings_read_cb read_cb,
+                             void *cb_arg, uint16_t *value) {
+    if (len != sizeof(*value)) {
+        LOG_ERR("Invalid settings data size for %s: %d", name, len);
+        return -EINVAL;
+    }
+
+    int rc = read_cb(cb_arg, value, sizeof(*value));
+    if (rc < 0) {
+        LOG_ERR("Failed to read settings for %s: %d", name, rc);
+        return rc;
+    }
+    return 0;
+}
+
+static int load_resolution(uint8_t sensor_index, const char *name, size_t len,
+                           settings_read_cb read_cb, void *cb_arg) {
+    uint16_t resolution;
+    int rc = load_sensor_value(name, len, read_cb, cb_arg, &resolution);
+    if (rc < 0) {
+        return rc;
+    }
+    if (resolution < ZMK_RUNTIME_SENSOR_ROTATE_MIN_RESOLUTION ||
+        resolution > ZMK_RUNTIME_SENSOR_ROTATE_MAX_RESOLUTION) {
+        LOG_WRN("Invalid resolution in settings for %s: %d", name, resolution);
+        return -EINVAL;
+    }
+    global_data.resolution[sensor_index] = resolution;
+    return 0;
+}
+
+static int load_max_latency(uint8_t sensor_index, const char *name, size_t len,
+                            settings_read_cb read_cb, void *cb_arg) {
+    uint16_t max_latency_ms;
+    int rc = load_sensor_value(name, len, read_cb, cb_arg, &max_latency_ms);
+    if (rc < 0) {
+        return rc;
+    }
+    global_data.max_latency_ms[sensor_index] = max_latency_ms;
+    global_data.max_latency_set[sensor_index] = true;
+    return 0;
+}
+
+static int load_active_profile(const char *name, size_t len, settings_read_cb read_cb,
+                               void *cb_arg) {
+    uint8_t profile;
+    if (len != sizeof(profile)) {
+        LOG_ERR("Invalid settings data size for %s: %d", name, len);
+        return -EINVAL;
+    }
+
+    int rc = read_cb(cb_arg, &profile, sizeof(profile));
+    if (rc < 0) {
+        LOG_ERR("Failed to read settings for %s: %d", name, rc);
+        return rc;
+    }
+    if (profile >= ZMK_RUNTIME_SENSOR_ROTATE_PROFILES) {
+        // Built with fewer profiles since it was saved
+        LOG_WRN("Invalid profile in settings for %s: %d", name, profile);
+        return -EINVAL;
+    }
+    // Unless switched since, like when the settings are reloaded to discard changes
+    if (active_profile() == global_data.saved_profile) {
+        atomic_set(&global_data.active_profile, profile);
+    }
+    global_data.saved_profile = profile;
+    return 0;
+}
+
+static int load_setting(const char *name, size_t len, settings_read_cb read_cb, void *cb_arg) {
+    int rc;
+    int profile = 0, sensor_index, channel = 0, layer, consumed = 0;
+
+    // Parse key format: [p<profile>/]s<sensor_index>[/res|/lat|[/c<channel>][/l<layer>[/accel]]]
+    // Example: "s0" for all layers of sensor 0
+    //          "s0/res" for the resolution of sensor 0
+    //          "s0/lat" for the maximum latency of sensor 0
+    //          "s0/l1" for sensor 0, layer 1
+    //          "s0/c1" and "s0/c1/l1" for channel 1 of sensor 0, channel 0 has no "/c"
+    //          "s0/l1/accel" for version 1 acceleration of sensor 0, layer 1
+    //          "p1/s0" and "p1/s0/l1" for the bindings of profile 1, profile 0 has no "p"
+    //          "profile" for the active profile
+    if (strcmp(name, "profile") == 0) {
+        return load_active_profile(name, len, read_cb, cb_arg);
+    }
+    const char *key = name;
+    if (sscanf(key, "p%d/%n", &profile, &consumed) == 1 && consumed > 0) {
+        if (profile <= 0 || profile >= ZMK_RUNTIME_SENSOR_ROTATE_PROFILES) {
+            LOG_WRN("Invalid profile in settings: %d", profile);
             return -EINVAL;
         }
+        key += consumed;
+        consumed = 0;
+    }
+    if (sscanf(key, "s%d%n", &sensor_index, &consumed) != 1) {
+        return -ENOENT;
+    }
+    if (sensor_index < 0 || sensor_index >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS) {
+        LOG_WRN("Invalid sensor index in settings: %d", sensor_index);
+        return -EINVAL;
+    }
+    // Shared by all profiles
+    if (profile == 0 && strcmp(key + consumed, "/res") == 0) {
+        return load_resolution(sensor_index, name, len, read_cb, cb_arg);
+    }
+    if (profile == 0 && strcmp(key + consumed, "/lat") == 0) {
+        return load_max_latency(sensor_index, name, len, read_cb, cb_arg);
+    }
 
-        if (len != sizeof(struct runtime_sensor_rotate_layer_bindings)) {
-            LOG_ERR("Invalid settings data size for s%d/l%d: %d vs %d", sensor_index, layer, len,
-                    sizeof(struct runtime_sensor_rotate_layer_bindings));
+    const char *suffix = key + consumed;
+    consumed = 0;
+    if (sscanf(suffix, "/c%d%n", &channel, &consumed) == 1) {
+        if (channel <= 0 || channel >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_CHANNELS) {
+            LOG_WRN("Invalid channel in settings: %d", channel);
             return -EINVAL;
         }
+        suffix += consumed;
+    }
+    if (*suffix == '\0') {
+        return load_sensor_record(profile, sensor_index, channel, name, len, read_cb, cb_arg);
+    }
 
-        rc = read_cb(cb_arg, &global_data.bindings[sensor_index][layer],
-                     sizeof(struct runtime_sensor_rotate_layer_bindings));
-        if (rc < 0) {
-            LOG_ERR("Failed to read settings for s%d/l%d: %d", sensor_index, layer, rc);
-            return rc;
+    consumed = 0;
+    if (sscanf(suffix, "/l%d%n", &layer, &consumed) != 1) {
+        return -ENOENT;
+    }
+    if (layer < 0 || layer >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS) {
+        LOG_WRN("Invalid layer in settings: %d", layer);
+        return -EINVAL;
+    }
+
+    suffix += consumed;
+    // Acceleration under its own key predates channels and profiles
+    if (*suffix != '\0' && (strcmp(suffix, "/accel") != 0 || channel != 0 || profile != 0)) {
+        return -ENOENT;
+    }
+
+    struct runtime_sensor_rotate_override *override =
+        find_or_alloc_override(profile, sensor_index, channel, layer);
+    if (!override) {
+        return -ENOMEM;
+    }
+
+    if (*suffix == '\0') {
+        rc = load_override(override, name, len, read_cb, cb_arg);
+    } else if (len != sizeof(struct runtime_sensor_rotate_acceleration)) {
+        LOG_ERR("Invalid settings data size for %s: %d", name, len);
+        rc = -EINVAL;
+    } else {
+        rc = read_cb(cb_arg, &override->acceleration, sizeof(override->acceleration));
+        atomic_set_bit(global_data.needs_migration, SETTINGS_BIT(0, sensor_index, 0, layer));
+    }
+
+    if (rc < 0) {
+        LOG_ERR("Failed to read settings for %s: %d", name, rc);
+        release_override_if_unused(override);
+        return rc;
+    }
+
+    publish_override(override);
+
+    LOG_DBG("Loaded %s", name);
+    return 0;
+}
+
+static int settings_set(const char *name, size_t len, settings_read_cb read_cb, void *cb_arg) {
+    k_mutex_lock(&config_lock, K_FOREVER);
+    int rc = load_setting(name, len, read_cb, cb_arg);
+    k_mutex_unlock(&config_lock);
+    return rc;
+}
+
+static int save_dirty(void);
+
+static void republish_overrides(void);
+
+static void migrate_work_handler(struct k_work *work) {
+    int rc = save_dirty();
+    if (rc != 0) {
+        LOG_ERR("Failed to migrate settings: %d", rc);
+    }
+}
+
+// Rewrites settings loaded from an older format or the other layout right after the settings
+// commit, without waiting for the save debounce
+static K_WORK_DEFINE(migrate_work, migrate_work_handler);
+
+static int settings_commit_handler(void) {
+    bool migrate = false;
+
+    k_mutex_lock(&config_lock, K_FOREVER);
+    // Bindings loaded before the behavior local IDs were resolved to nothing
+    republish_overrides();
+
+    for (int bit = 0; bit < SETTINGS_BITS; bit++) {
+        if (atomic_test_bit(global_data.needs_migration, bit)) {
+            atomic_set_bit(global_data.dirty, bit);
+            migrate = true;
+        }
+    }
+    if (migrate) {
+        k_work_submit(&migrate_work);
+    }
+    for (uint8_t s = 0; s < ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS; s++) {
+        bump_generation(s);
+    }
+    bump_global_generation();
+    k_mutex_unlock(&config_lock);
+    return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(behavior_runtime_sensor_rotate, SETTINGS_KEY, NULL, settings_set,
+                               settings_commit_handler, NULL);
+
+// Settings key of a sensor channel: "s<S>" for channel 0, so that keys written before channels
+// existed keep loading, and "s<S>/c<C>" for the others. Profiles other than 0 prefix it with
+// "p<P>/", so that keys written before profiles existed load into profile 0.
+static void channel_key(char *key, size_t size, uint8_t profile, uint8_t sensor_index,
+                        uint8_t channel) {
+    int len = profile == 0 ? snprintf(key, size, SETTINGS_KEY "/s%d", sensor_index)
+                           : snprintf(key, size, SETTINGS_KEY "/p%d/s%d", profile, sensor_index);
+    if (channel != 0) {
+        snprintf(key + len, size - len, "/c%d", channel);
+    }
+}
+
+// Delete the keys a sensor/layer was loaded from that the configured layout doesn't use
+static void delete_migrated_keys(uint8_t profile, uint8_t sensor_index, uint8_t channel,
+                                 uint8_t layer) {
+    char prefix[24];
+    char key[40];
+
+    channel_key(prefix, sizeof(prefix), profile, sensor_index, channel);
+    if (profile == 0 && channel == 0) {
+        snprintf(key, sizeof(key), "%s/l%d/accel", prefix, layer);
+        settings_delete(key);
+    }
+    if (IS_ENABLED(CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_SETTINGS_PER_SENSOR)) {
+        snprintf(key, sizeof(key), "%s/l%d", prefix, layer);
+        settings_delete(key);
+    }
+}
+
+#if IS_ENABLED(CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_SETTINGS_PER_SENSOR)
+
+// Only accessed from save_dirty, which is serialized by config_lock
+static struct runtime_sensor_rotate_sensor_settings_record sensor_settings_save_buffer;
+
+static int save_sensor(uint8_t profile, uint8_t sensor_index, uint8_t channel) {
+    struct runtime_sensor_rotate_sensor_settings_record *record = &sensor_settings_save_buffer;
+    char key[24];
+    channel_key(key, sizeof(key), profile, sensor_index, channel);
+
+    record->header = (struct runtime_sensor_rotate_sensor_settings_header){
+        .version = SENSOR_SETTINGS_VERSION,
+    };
+    for (uint8_t l = 0; l < ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS; l++) {
+        struct runtime_sensor_rotate_override *override =
+            find_override(profile, sensor_index, channel, l);
+        if (!override) {
+            continue;
+        }
+        record->entries[record->header.count++] =
+            (struct runtime_sensor_rotate_sensor_settings_entry){
+                .layer = l,
+                .acceleration = override->acceleration,
+                .bindings = override->bindings,
+            };
+    }
+
+    if (record->header.count == 0) {
+        // Back to the defaults, nothing to keep
+        return settings_delete(key);
+    }
+    return settings_save_one(key, record,
+                             sizeof(record->header) +
+                                 record->header.count * sizeof(record->entries[0]));
+}
+
+#else
+
+static int save_override(uint8_t profile, uint8_t sensor_index, uint8_t channel, uint8_t layer) {
+    struct runtime_sensor_rotate_override *override =
+        find_override(profile, sensor_index, channel, layer);
+    char prefix[24];
+    char key[32];
+    channel_key(prefix, sizeof(prefix), profile, sensor_index, channel);
+    snprintf(key, sizeof(key), "%s/l%d", prefix, layer);
+
+    if (!override) {
+        // Back to the defaults, nothing to keep
+        return settings_delete(key);
+    }
+
+    struct runtime_sensor_rotate_settings_record record = {
+        .version = SETTINGS_VERSION,
+        .acceleration = override->acceleration,
+        .bindings = override->bindings,
+    };
+    return settings_save_one(key, &record, sizeof(record));
+}
+
+#endif
+
+// Save a sensor channel when any of its layers changed since the last save. Keys of the other
+// layout or of older formats are deleted once it has been written in the configured one.
+static int save_dirty_channel(uint8_t p, uint8_t s, uint8_t c) {
+    bool migrated = false;
+
+#if IS_ENABLED(CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_SETTINGS_PER_SENSOR)
+    bool dirty = false;
+    for (uint8_t l = 0; l < ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS; l++) {
+        dirty |= atomic_test_and_clear_bit(global_data.dirty, SETTINGS_BIT(p, s, c, l));
+    }
+    if (!dirty) {
+        return 0;
+    }
+    int rc = save_sensor(p, s, c);
+    if (rc != 0) {
+        LOG_ERR("Failed to save settings for profile %d sensor %d channel %d: %d", p, s, c, rc);
+        // Any bit makes the next save rewrite the whole sensor channel
+        atomic_set_bit(global_data.dirty, SETTINGS_BIT(p, s, c, 0));
+        return rc;
+    }
+#else
+    bool saved = false;
+    int rc = 0;
+    for (uint8_t l = 0; l < ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS; l++) {
+        int bit = SETTINGS_BIT(p, s, c, l);
+        if (!atomic_test_and_clear_bit(global_data.dirty, bit)) {
+            continue;
+        }
+        int layer_rc = save_override(p, s, c, l);
+        if (layer_rc != 0) {
+            LOG_ERR("Failed to save settings for profile %d sensor %d channel %d layer %d: %d", p,
+                    s, c, l, layer_rc);
+            atomic_set_bit(global_data.dirty, bit);
+            rc = layer_rc;
+        }
+        saved = true;
+    }
+    if (!saved || rc != 0) {
+        // Keep the old keys until every layer of the sensor channel is written
+        return rc;
+    }
+#endif
+
+    for (uint8_t l = 0; l < ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS; l++) {
+        if (atomic_test_and_clear_bit(global_data.needs_migration, SETTINGS_BIT(p, s, c, l))) {
+            delete_migrated_keys(p, s, c, l);
+            migrated = true;
         }
+    }
+    if (migrated && IS_ENABLED(CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_SETTINGS_PER_LAYER)) {
+        char key[24];
+        channel_key(key, sizeof(key), p, s, c);
+        settings_delete(key);
+    }
+    return 0;
+}
+
+static int save_sensor_tuning(uint8_t sensor_index);
+
+// Save all sensor channel/layers and sensor tuning changed since the last save in one pass
+static int save_dirty(void) {
+    int ret = 0;
+
+    k_mutex_lock(&config_lock, K_FOREVER);
+    for (uint8_t s = 0; s < ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS; s++) {
+        if (!atomic_test_and_clear_bit(global_data.tuning_dirty, s)) {
+            continue;
+        }
+        int rc = save_sensor_tuning(s);
+        if (rc != 0) {
+            LOG_ERR("Failed to save tuning of sensor %d: %d", s, rc);
+            atomic_set_bit(global_data.tuning_dirty, s);
+            ret = rc;
+        }
+    }
+    for (uint8_t p = 0; p < ZMK_RUNTIME_SENSOR_ROTATE_PROFILES; p++) {
+        for (uint8_t s = 0; s < ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS; s++) {
+            for (uint8_t c = 0; c < ZMK_RUNTIME_SENSOR_ROTATE_MAX_CHANNELS; c++) {
+                int rc = save_dirty_channel(p, s, c);
+                if (rc != 0) {
+                    ret = rc;
+                }
+            }
+        }
+    }
+    k_mutex_unlock(&config_lock);
+    return ret;
+}
+
+static void save_work_handler(struct k_work *work) { save_dirty(); }
+
+static K_WORK_DELAYABLE_DEFINE(save_work, save_work_handler);
+
+static void mark_dirty(int bit) {
+    atomic_set_bit(global_data.dirty, bit);
+    k_work_reschedule(&save_work, K_MSEC(CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_SETTINGS_SAVE_DEBOUNCE));
+}
+
+// Persist a change right away or after the debounce period, depending on the config
+static int schedule_save(uint8_t profile, uint8_t sensor_index, uint8_t channel, uint8_t layer) {
+    int bit = SETTINGS_BIT(profile, sensor_index, channel, layer);
+    if (CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_SETTINGS_SAVE_DEBOUNCE == 0) {
+        atomic_set_bit(global_data.dirty, bit);
+        return save_dirty();
+    }
+    mark_dirty(bit);
+    return 0;
+}
+
+// schedule_save for the resolution and max latency of a sensor
+static int schedule_tuning_save(uint8_t sensor_index) {
+    atomic_set_bit(global_data.tuning_dirty, sensor_index);
+    if (CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_SETTINGS_SAVE_DEBOUNCE == 0) {
+        return save_dirty();
+    }
+    k_work_reschedule(&save_work, K_MSEC(CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_SETTINGS_SAVE_DEBOUNCE));
+    return 0;
+}
+
+int zmk_runtime_sensor_rotate_save_changes(void) {
+    k_work_cancel_delayable(&save_work);
+    return save_dirty();
+}
+
+int zmk_runtime_sensor_rotate_discard_changes(void) {
+    k_work_cancel_delayable(&save_work);
+
+    // Held across the reload, so that no change sneaks in between
+    k_mutex_lock(&config_lock, K_FOREVER);
+    for (uint8_t s = 0; s < ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS; s++) {
+        if (atomic_test_and_clear_bit(global_data.tuning_dirty, s)) {
+            // Defaults until the stored values are reloaded below
+            global_data.resolution[s] = 0;
+            global_data.max_latency_set[s] = false;
+        }
+    }
+    for (uint8_t p = 0; p < ZMK_RUNTIME_SENSOR_ROTATE_PROFILES; p++) {
+        for (uint8_t s = 0; s < ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS; s++) {
+            for (uint8_t c = 0; c < ZMK_RUNTIME_SENSOR_ROTATE_MAX_CHANNELS; c++) {
+                for (uint8_t l = 0; l < ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS; l++) {
+                    if (!atomic_test_and_clear_bit(global_data.dirty, SETTINGS_BIT(p, s, c, l))) {
+                        continue;
+                    }
+                    // Back to the defaults until the stored values are reloaded below
+                    struct runtime_sensor_rotate_override *override = find_override(p, s, c, l);
+                    if (override) {
+                        override->bindings = (struct runtime_sensor_rotate_layer_bindings){};
+                        override->acceleration = (struct runtime_sensor_rotate_acceleration){};
+                        release_override_if_unused(override);
+                    }
+                }
+            }
+        }
+    }
+
+    int rc = settings_load_subtree(SETTINGS_KEY);
+    k_mutex_unlock(&config_lock);
+    return rc;
+}
+
+bool zmk_runtime_sensor_rotate_has_unsaved_changes(void) {
+    for (size_t i = 0; i < ARRAY_SIZE(global_data.dirty); i++) {
+        if (atomic_get(&global_data.dirty[i]) != 0) {
+            return true;
+        }
+    }
+    for (size_t i = 0; i < ARRAY_SIZE(global_data.tuning_dirty); i++) {
+        if (atomic_get(&global_data.tuning_dirty[i]) != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool resolve_binding(const struct runtime_sensor_rotate_binding *runtime_binding,
+                            const char *default_name,
+                            const struct runtime_sensor_rotate_binding *default_params,
+                            struct runtime_sensor_rotate_resolved_binding *out) {
+    *out = (struct runtime_sensor_rotate_resolved_binding){.transparent = true};
+
+    if (runtime_binding->behavior_local_id != 0) {
+        const char *behavior_name = NULL;
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_LOCAL_IDS_IN_BINDINGS)
+        behavior_name =
+            zmk_behavior_find_behavior_name_from_local_id(runtime_binding->behavior_local_id);
+#endif
+        if (!behavior_name) {
+            LOG_ERR("Failed to find behavior for local_id %d", runtime_binding->behavior_local_id);
+            // Not cached, so that it is retried once local IDs become available
+            return false;
+        }
+        out->behavior_dev = behavior_name;
+        out->behavior_local_id = runtime_binding->behavior_local_id;
+        out->param1 = runtime_binding->param1;
+        out->param2 = runtime_binding->param2;
+        out->tap_ms = runtime_binding->tap_ms;
+        out->hold_ms = runtime_binding->hold_ms;
+    } else if (default_name != NULL) {
+        out->behavior_dev = default_name;
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_LOCAL_IDS)
+        // Also reported to the RPC getters, so looked up even when bindings don't carry it
+        out->behavior_local_id = zmk_behavior_get_local_id(default_name);
+#endif
+        out->param1 = default_params->param1;
+        out->param2 = default_params->param2;
+        out->tap_ms = default_params->tap_ms;
+        out->hold_ms = default_params->hold_ms;
+    } else {
+        return true;
+    }
+
+    out->transparent = strcmp(out->behavior_dev, "transparent") == 0;
+    return true;
+}
+
+// The devicetree defaults only apply to channel 0, other channels are transparent unless bound
+// at runtime
+static void resolve_layer_bindings(const struct runtime_sensor_rotate_layer_bindings *bindings,
+                                   const struct behavior_runtime_sensor_rotate_config *config,
+                                   uint8_t channel,
+                                   struct runtime_sensor_rotate_resolved_layer_bindings *resolved) {
+    const struct behavior_runtime_sensor_rotate_config *defaults = channel == 0 ? config : NULL;
+    bool cw_ok = resolve_binding(&bindings->cw_binding,
+                                 defaults ? defaults->default_cw_binding_name : NULL,
+                                 defaults ? &defaults->default_cw_binding_params : NULL,
+                                 &resolved->cw_binding);
+    bool ccw_ok = resolve_binding(&bindings->ccw_binding,
+                                  defaults ? defaults->default_ccw_binding_name : NULL,
+                                  defaults ? &defaults->default_ccw_binding_params : NULL,
+                                  &resolved->ccw_binding);
+    resolved->config = config;
+    resolved->valid = cw_ok && ccw_ok;
+}
+
+// Map each sensor/layer to the behavior instance bound in the keymap and resolve the default
+// bindings of each instance once, local IDs included. Both the sensor event path and the RPC
+// getters read the defaults from there. The sensor event path and a writer may both get here
+// first, which is harmless as both store the same values.
+static void init_default_slots(void) {
+    static const struct runtime_sensor_rotate_layer_bindings no_bindings = {};
+
+#if ZMK_KEYMAP_HAS_SENSORS
+    for (uint8_t s = 0; s < ZMK_KEYMAP_SENSORS_LEN; s++) {
+        for (uint8_t l = 0; l < ZMK_KEYMAP_LAYERS_LEN; l++) {
+            const struct device *dev = default_behaviors[s][l];
+            if (dev == NULL) {
+                continue;
+            }
+            const struct behavior_runtime_sensor_rotate_config *config = dev->config;
+            struct runtime_sensor_rotate_resolved_layer_bindings resolved;
+            resolve_layer_bindings(&no_bindings, config, 0, &resolved);
+            global_data.defaults[config->index] = resolved;
+            global_data.default_slot[s][l] = config->index + 1;
+        }
+    }
+#endif
+    barrier_dmem_fence_full();
+    global_data.default_slots_initialized = true;
+    invalidate_effective_layers();
+}
+
+static const struct behavior_runtime_sensor_rotate_config *
+get_default_config(uint8_t sensor_index, uint8_t layer) {
+    if (!global_data.default_slots_initialized) {
+        init_default_slots();
+    }
+    uint8_t slot = global_data.default_slot[sensor_index][layer];
+    return slot ? global_data.defaults[slot - 1].config : NULL;
+}
+
+__weak void rsr_test_preempt(void) {}
+
+// Copy a word at a time, with a test seam in between, so that tests/stress can preempt the copy
+// where preemption on hardware could. Only runs on configuration changes.
+static void write_snapshot(struct runtime_sensor_rotate_snapshot *dst,
+                           const struct runtime_sensor_rotate_snapshot *src) {
+    for (size_t i = 0; i < sizeof(*dst); i += sizeof(uint32_t)) {
+        memcpy((uint8_t *)dst + i, (const uint8_t *)src + i,
+               MIN(sizeof(uint32_t), sizeof(*dst) - i));
+        rsr_test_preempt();
+    }
+}
+
+// Resolve the configuration of an override slot and hand it to the sensor event path. Callers
+// hold config_lock.
+static void publish_override(struct runtime_sensor_rotate_override *override) {
+    struct runtime_sensor_rotate_latch *latch =
+        &global_data.published[override - global_data.overrides];
+    struct runtime_sensor_rotate_snapshot snapshot = {
+        .acceleration = override->acceleration,
+        .profile = override->profile,
+        .sensor_index = override->sensor_index,
+        .channel = override->channel,
+        .layer = override->layer,
+        .in_use = override->in_use,
+    };
+    if (override->in_use) {
+        resolve_layer_bindings(&override->bindings,
+                               get_default_config(override->sensor_index, override->layer),
+                               override->channel, &snapshot.resolved);
+    }
+
+    for (size_t i = 0; i < ARRAY_SIZE(latch->copies); i++) {
+        // Steer readers to the other copy before touching this one. atomic_inc is a full barrier,
+        // so the previous copy is complete before readers are steered to it.
+        atomic_inc(&latch->seq);
+        write_snapshot(&latch->copies[i], &snapshot);
+    }
+    invalidate_effective_layers();
+    atomic_clear(&global_data.republish_requested);
+}
+
+static void republish_overrides(void) {
+    for (int i = 0; i < RUNTIME_SENSOR_ROTATE_MAX_OVERRIDES; i++) {
+        if (global_data.overrides[i].in_use) {
+            publish_override(&global_data.overrides[i]);
+        }
+    }
+}
+
+static void republish_work_handler(struct k_work *work) {
+    k_mutex_lock(&config_lock, K_FOREVER);
+    republish_overrides();
+    // One retry per change. Bindings that still don't resolve stay transparent until the next
+    // publish rather than queueing this again on every sensor event.
+    atomic_set(&global_data.republish_requested, 1);
+    k_mutex_unlock(&config_lock);
+}
+
+static K_WORK_DEFINE(republish_work, republish_work_handler);
+
+// Copy out the published snapshot of the override of a sensor channel/layer in the active
+// profile, false if it has none. Lock-free, for the sensor event path.
+static bool read_override(uint8_t sensor_index, uint8_t channel, uint8_t layer,
+                          struct runtime_sensor_rotate_snapshot *out) {
+    if (sensor_index >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS ||
+        layer >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS) {
+        return false;
+    }
+
+    uint8_t profile = active_profile();
+    uint8_t slot =
+        global_data.override_slot[profile][SENSOR_CHANNEL(sensor_index, channel)][layer];
+    if (!slot) {
+        return false;
+    }
+
+    struct runtime_sensor_rotate_latch *latch = &global_data.published[slot - 1];
+    atomic_val_t seq;
+    do {
+        seq = atomic_get(&latch->seq);
+        *out = latch->copies[seq & 1];
+        barrier_dmem_fence_full();
+    } while (atomic_get(&latch->seq) != seq);
+
+    // The slot may have been released or handed to another sensor/layer since reading its index
+    return out->in_use && out->profile == profile && out->sensor_index == sensor_index &&
+           out->channel == channel && out->layer == layer;
+}
+
+// Resolved bindings of a sensor channel/layer, false if no instance of this behavior is bound to
+// the sensor on the layer
+static bool get_resolved_layer_bindings(uint8_t sensor_index, uint8_t channel, uint8_t layer,
+                                        struct runtime_sensor_rotate_resolved_layer_bindings *out) {
+    if (!global_data.default_slots_initialized) {
+        init_default_slots();
+    }
+
+    struct runtime_sensor_rotate_snapshot snapshot;
+    if (read_override(sensor_index, channel, layer, &snapshot)) {
+        if (!snapshot.resolved.valid) {
+            // Retried by the writer side, the unresolved direction stays transparent until then
+            if (atomic_cas(&global_data.republish_requested, 0, 1)) {
+                k_work_submit(&republish_work);
+            }
+        }
+        *out = snapshot.resolved;
+        return true;
+    }
+
+    uint8_t slot = global_data.default_slot[sensor_index][layer];
+    if (!slot) {
+        return false;
+    }
+    if (channel == 0) {
+        *out = global_data.defaults[slot - 1];
+    } else {
+        *out = (struct runtime_sensor_rotate_resolved_layer_bindings){
+            .cw_binding = {.transparent = true},
+            .ccw_binding = {.transparent = true},
+            .config = global_data.defaults[slot - 1].config,
+            .valid = true,
+        };
+    }
+    return true;
+}
+
+// Walk the layers top-down like zmk_keymap_sensor_event, to the first active one that plays the
+// triggers of a sensor channel in a direction
+static int find_effective_layer(uint8_t sensor_index, uint8_t channel, int direction) {
+#if ZMK_KEYMAP_HAS_SENSORS
+    // Walked by index like zmk_keymap_sensor_event, which differs from the layer ID once layers
+    // are reordered in Studio
+    int default_idx = zmk_keymap_layer_id_to_index(zmk_keymap_layer_default());
+    for (int idx = ZMK_KEYMAP_LAYERS_LEN - 1; idx >= default_idx; idx--) {
+        zmk_keymap_layer_id_t layer = zmk_keymap_layer_index_to_id(idx);
+        if (layer >= ZMK_KEYMAP_LAYERS_LEN || !sensor_bound[sensor_index][layer] ||
+            !zmk_keymap_layer_active(layer)) {
+            continue;
+        }
+
+        struct runtime_sensor_rotate_resolved_layer_bindings resolved;
+        if (!get_resolved_layer_bindings(sensor_index, channel, layer, &resolved)) {
+            return EFFECTIVE_LAYER_OTHER;
+        }
+        if (!(direction > 0 ? resolved.cw_binding : resolved.ccw_binding).transparent) {
+            return layer;
+        }
+    }
+    return EFFECTIVE_LAYER_NONE;
+#else
+    return EFFECTIVE_LAYER_OTHER;
+#endif
+}
+
+// Drop the cached effective layers if the default layer or the layer order moved since they were
+// found. A walk over the index to ID mapping, still far cheaper than resolving bindings per layer.
+static void check_effective_layout(void) {
+    bool changed = false;
+    zmk_keymap_layer_id_t default_layer = zmk_keymap_layer_default();
+
+    if (global_data.effective_default_layer != default_layer) {
+        global_data.effective_default_layer = default_layer;
+        changed = true;
+    }
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_LAYER_REORDERING)
+    for (int idx = 0; idx < ZMK_KEYMAP_LAYERS_LEN; idx++) {
+        zmk_keymap_layer_id_t layer = zmk_keymap_layer_index_to_id(idx);
+        if (global_data.effective_layer_order[idx] != layer) {
+            global_data.effective_layer_order[idx] = layer;
+            changed = true;
+        }
+    }
+#endif
+    if (changed) {
+        invalidate_effective_layers();
+    }
+}
+
+// Layer whose binding plays the triggers of a sensor channel in a direction, EFFECTIVE_LAYER_NONE
+// or EFFECTIVE_LAYER_OTHER. Cached until the layer state, the layer order or a binding changes, so
+// that a detent costs one lookup no matter how many transparent layers sit above the effective one.
+static int get_effective_layer(uint8_t sensor_index, uint8_t channel, int direction) {
+    check_effective_layout();
+
+    struct runtime_sensor_rotate_effective_layer *cached =
+        &global_data.effective[SENSOR_CHANNEL(sensor_index, channel)][direction < 0];
+    // Read before the walk, so that a change during it leaves the result stale rather than valid
+    uint32_t epoch = (uint32_t)atomic_get(&global_data.effective_epoch);
+
+    if (!cached->valid || cached->epoch != epoch) {
+        cached->layer = find_effective_layer(sensor_index, channel, direction);
+        cached->epoch = epoch;
+        cached->valid = true;
+    }
+    return cached->layer;
+}
+
+int zmk_runtime_sensor_rotate_get_layer_bindings(
+    uint8_t sensor_index, uint8_t layer, struct runtime_sensor_rotate_layer_bindings *bindings) {
+
+    if (sensor_index >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS) {
+        return -EINVAL;
+    }
+    if (layer >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS) {
+        return -EINVAL;
+    }
+
+    k_mutex_lock(&config_lock, K_FOREVER);
+    const struct runtime_sensor_rotate_override *override =
+        find_override(active_profile(), sensor_index, 0, layer);
+    *bindings = override ? override->bindings : (struct runtime_sensor_rotate_layer_bindings){};
+    k_mutex_unlock(&config_lock);
+    return 0;
+}
+
+int zmk_runtime_sensor_rotate_set_layer_bindings(
+    uint8_t sensor_index, uint8_t layer,
+    const struct runtime_sensor_rotate_layer_bindings *bindings) {
+
+    if (sensor_index >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS) {
+        return -EINVAL;
+    }
+    if (layer >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS) {
+        return -EINVAL;
+    }
+
+    k_mutex_lock(&config_lock, K_FOREVER);
+    uint8_t profile = active_profile();
+    struct runtime_sensor_rotate_override *override =
+        find_or_alloc_override(profile, sensor_index, 0, layer);
+    if (!override) {
+        k_mutex_unlock(&config_lock);
+        return -ENOMEM;
+    }
+
+    override->bindings = *bindings;
+    publish_override(override);
+    release_override_if_unused(override);
+    bump_generation(sensor_index);
+    bump_global_generation();
+
+    // Save to settings with per-sensor, per-layer key
+    int rc = schedule_save(profile, sensor_index, 0, layer);
+    k_mutex_unlock(&config_lock);
+    if (rc != 0) {
+        LOG_ERR("Failed to save settings for sensor %d layer %d: %d", sensor_index, layer, rc);
+        return rc;
+    }
+
+    LOG_DBG("Set bindings (local_id=%d) for sensor %d layer %d",
+            bindings->cw_binding.behavior_local_id, sensor_index, layer);
+    return 0;
+}
+
+int zmk_runtime_sensor_rotate_get_channel_acceleration(
+    uint8_t sensor_index, uint8_t channel, uint8_t layer,
+    struct runtime_sensor_rotate_acceleration *out) {
+    if (sensor_index >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS) {
+        return -EINVAL;
+    }
+    if (channel >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_CHANNELS) {
+        return -EINVAL;
+    }
+    if (layer >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS) {
+        return -EINVAL;
+    }
+
+    k_mutex_lock(&config_lock, K_FOREVER);
+    const struct runtime_sensor_rotate_override *override =
+        find_override(active_profile(), sensor_index, channel, layer);
+    *out = override ? override->acceleration : (struct runtime_sensor_rotate_acceleration){};
+    k_mutex_unlock(&config_lock);
+    return 0;
+}
+
+int zmk_runtime_sensor_rotate_get_acceleration(uint8_t sensor_index, uint8_t layer,
+                                               struct runtime_sensor_rotate_acceleration *out) {
+    return zmk_runtime_sensor_rotate_get_channel_acceleration(sensor_index, 0, layer, out);
+}
+
+int zmk_runtime_sensor_rotate_set_acceleration(
+    uint8_t sensor_index, uint8_t layer, const struct runtime_sensor_rotate_acceleration *accel) {
+    if (sensor_index >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS) {
+        return -EINVAL;
+    }
+    if (layer >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS) {
+        return -EINVAL;
+    }
+
+    k_mutex_lock(&config_lock, K_FOREVER);
+    uint8_t profile = active_profile();
+    struct runtime_sensor_rotate_override *override =
+        find_or_alloc_override(profile, sensor_index, 0, layer);
+    if (!override) {
+        k_mutex_unlock(&config_lock);
+        return -ENOMEM;
+    }
+
+    override->acceleration = *accel;
+    publish_override(override);
+    release_override_if_unused(override);
+    bump_generation(sensor_index);
+    bump_global_generation();
+
+    int rc = schedule_save(profile, sensor_index, 0, layer);
+    k_mutex_unlock(&config_lock);
+    if (rc != 0) {
+        LOG_ERR("Failed to save acceleration for sensor %d layer %d: %d", sensor_index, layer, rc);
+        return rc;
+    }
+
+    LOG_DBG("Set acceleration (threshold=%dms multiplier=%d%% max=%d) for sensor %d layer %d",
+            accel->threshold_ms, accel->multiplier, accel->max_triggers, sensor_index, layer);
+    return 0;
+}
+
+// Save one of the uint16_t values kept per sensor under their own key, or delete the key when
+// back to the default
+static int save_sensor_value(uint8_t sensor_index, const char *suffix, uint16_t value,
+                             uint16_t default_value) {
+    char key[16];
+    snprintf(key, sizeof(key), SETTINGS_KEY "/s%d/%s", sensor_index, suffix);
+    return value == default_value ? settings_delete(key)
+                                  : settings_save_one(key, &value, sizeof(value));
+}
+
+static uint16_t get_resolution(uint8_t sensor_index) {
+    if (sensor_index >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS) {
+        return 100;
+    }
+    uint16_t resolution = global_data.resolution[sensor_index];
+    return resolution ? resolution : 100;
+}
+
+uint16_t zmk_runtime_sensor_rotate_get_resolution(uint8_t sensor_index) {
+    if (sensor_index >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS) {
+        return 0;
+    }
+    return get_resolution(sensor_index);
+}
+
+int zmk_runtime_sensor_rotate_set_resolution(uint8_t sensor_index, uint16_t percent) {
+    if (sensor_index >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS) {
+        return -EINVAL;
+    }
+    if (percent < ZMK_RUNTIME_SENSOR_ROTATE_MIN_RESOLUTION ||
+        percent > ZMK_RUNTIME_SENSOR_ROTATE_MAX_RESOLUTION) {
+        return -EINVAL;
+    }
+
+    k_mutex_lock(&config_lock, K_FOREVER);
+    // The remainder of the accumulator doesn't depend on the resolution, so it carries over
+    global_data.resolution[sensor_index] = percent;
+    bump_generation(sensor_index);
+    bump_global_generation();
+    int rc = schedule_tuning_save(sensor_index);
+    k_mutex_unlock(&config_lock);
+
+    if (rc != 0) {
+        LOG_ERR("Failed to save resolution for sensor %d: %d", sensor_index, rc);
+        return rc;
+    }
+
+    LOG_DBG("Set resolution %d%% for sensor %d", percent, sensor_index);
+    return 0;
+}
+
+static uint16_t get_max_latency(uint8_t sensor_index) {
+    if (sensor_index >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS ||
+        !global_data.max_latency_set[sensor_index]) {
+        return CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_MAX_LATENCY_MS;
+    }
+    return global_data.max_latency_ms[sensor_index];
+}
+
+uint16_t zmk_runtime_sensor_rotate_get_max_latency(uint8_t sensor_index) {
+    if (sensor_index >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS) {
+        return 0;
+    }
+    return get_max_latency(sensor_index);
+}
+
+int zmk_runtime_sensor_rotate_set_max_latency(uint8_t sensor_index, uint16_t max_latency_ms) {
+    if (sensor_index >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS) {
+        return -EINVAL;
+    }
+
+    k_mutex_lock(&config_lock, K_FOREVER);
+    global_data.max_latency_ms[sensor_index] = max_latency_ms;
+    global_data.max_latency_set[sensor_index] = true;
+    bump_generation(sensor_index);
+    bump_global_generation();
+    int rc = schedule_tuning_save(sensor_index);
+    k_mutex_unlock(&config_lock);
+
+    if (rc != 0) {
+        LOG_ERR("Failed to save max latency for sensor %d: %d", sensor_index, rc);
+        return rc;
+    }
+
+    LOG_DBG("Set max latency %dms for sensor %d", max_latency_ms, sensor_index);
+    return 0;
+}
+
+static int save_sensor_tuning(uint8_t sensor_index) {
+    int rc = save_sensor_value(sensor_index, "res", get_resolution(sensor_index), 100);
+    if (rc != 0) {
+        return rc;
+    }
+    return save_sensor_value(sensor_index, "lat", get_max_latency(sensor_index),
+                             CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_MAX_LATENCY_MS);
+}
+
+#if ZMK_RUNTIME_SENSOR_ROTATE_PROFILES > 1
+
+// Save the active profile once it stayed the same for a while, profile 0 by deleting the key
+static void profile_save_work_handler(struct k_work *work) {
+    k_mutex_lock(&config_lock, K_FOREVER);
+    uint8_t profile = active_profile();
+    if (profile != global_data.saved_profile) {
+        int rc = profile == 0 ? settings_delete(SETTINGS_KEY "/profile")
+                              : settings_save_one(SETTINGS_KEY "/profile", &profile,
+                                                  sizeof(profile));
+        if (rc != 0) {
+            LOG_ERR("Failed to save active profile %d: %d", profile, rc);
+        } else {
+            global_data.saved_profile = profile;
+        }
+    }
+    k_mutex_unlock(&config_lock);
+}
+
+static K_WORK_DELAYABLE_DEFINE(profile_save_work, profile_save_work_handler);
+
+#endif
+
+uint8_t zmk_runtime_sensor_rotate_get_active_profile(void) { return active_profile(); }
+
+int zmk_runtime_sensor_rotate_set_active_profile(uint8_t profile) {
+    if (profile >= ZMK_RUNTIME_SENSOR_ROTATE_PROFILES) {
+        return -EINVAL;
+    }
+    if ((uint8_t)atomic_set(&global_data.active_profile, profile) == profile) {
+        return 0;
+    }
+
+    // Nothing is copied, read_override looks the overrides up in the new profile from the next
+    // sensor event on
+    invalidate_effective_layers();
+    for (uint8_t s = 0; s < ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS; s++) {
+        bump_generation(s);
+    }
+    bump_global_generation();
+#if ZMK_RUNTIME_SENSOR_ROTATE_PROFILES > 1
+    k_work_reschedule(&profile_save_work,
+                      K_MSEC(CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_PROFILE_SAVE_DELAY_MS));
+#endif
+
+    LOG_DBG("Switched to profile %d", profile);
+    return 0;
+}
+
+int zmk_runtime_sensor_rotate_apply_updates(const struct runtime_sensor_rotate_update *updates,
+                                            size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        if (updates[i].sensor_index >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS ||
+            updates[i].channel >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_CHANNELS ||
+            updates[i].layer >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS ||
+            updates[i].type > RUNTIME_SENSOR_ROTATE_UPDATE_ACCELERATION) {
+            LOG_ERR("Invalid update %d for sensor %d channel %d layer %d", i,
+                    updates[i].sensor_index, updates[i].channel, updates[i].layer);
+            return -EINVAL;
+        }
+    }
+
+    k_mutex_lock(&config_lock, K_FOREVER);
+    // The whole batch goes to the profile active when it started
+    uint8_t profile = active_profile();
+
+    // Reserve all slots first so that running out of them leaves everything untouched. Slots
+    // allocated here are still empty and freed again on failure.
+    for (size_t i = 0; i < count; i++) {
+        if (!find_or_alloc_override(profile, updates[i].sensor_index, updates[i].channel,
+                                    updates[i].layer)) {
+            for (size_t j = 0; j < i; j++) {
+                struct runtime_sensor_rotate_override *override = find_override(
+                    profile, updates[j].sensor_index, updates[j].channel, updates[j].layer);
+                if (override) {
+                    release_override_if_unused(override);
+                }
+            }
+            k_mutex_unlock(&config_lock);
+            return -ENOMEM;
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        const struct runtime_sensor_rotate_update *update = &updates[i];
+        struct runtime_sensor_rotate_override *override =
+            find_override(profile, update->sensor_index, update->channel, update->layer);
+
+        switch (update->type) {
+        case RUNTIME_SENSOR_ROTATE_UPDATE_CW_BINDING:
+            override->bindings.cw_binding = update->binding;
+            break;
+        case RUNTIME_SENSOR_ROTATE_UPDATE_CCW_BINDING:
+            override->bindings.ccw_binding = update->binding;
+            break;
+        case RUNTIME_SENSOR_ROTATE_UPDATE_ACCELERATION:
+            override->acceleration = update->acceleration;
+            break;
+        }
+        atomic_set_bit(global_data.dirty, SETTINGS_BIT(profile, update->sensor_index,
+                                                       update->channel, update->layer));
+        bump_generation(update->sensor_index);
+    }
+
+    // Published once all updates of a sensor channel/layer are in, so that the sensor event path
+    // never sees half a batch for it
+    for (size_t i = 0; i < count; i++) {
+        struct runtime_sensor_rotate_override *override =
+            find_override(profile, updates[i].sensor_index, updates[i].channel, updates[i].layer);
+        if (override) {
+            publish_override(override);
+            release_override_if_unused(override);
+        }
+    }
+
+    LOG_DBG("Applied %d updates", count);
+
+    int rc = 0;
+    if (count > 0) {
+        // Once per batch, so that a client can tell whether anything else changed meanwhile
+        bump_global_generation();
+
+        // All changes go out in a single save pass
+        if (CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_SETTINGS_SAVE_DEBOUNCE == 0) {
+            rc = save_dirty();
+        } else {
+            k_work_reschedule(&save_work,
+                              K_MSEC(CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_SETTINGS_SAVE_DEBOUNCE));
+        }
+    }
+    k_mutex_unlock(&config_lock);
+    return rc;
+}
+
+// Blob of zmk_runtime_sensor_rotate_export_config: the header, the names of the behaviors bound,
+// each a length byte followed by the characters, a tuning record per sensor and an entry per
+// override of any profile. Packed and little-endian like the settings records.
+#define CONFIG_BLOB_MAGIC 0x31525352
+#define CONFIG_BLOB_VERSION 1
+// Behavior of a binding that isn't set, also the bound of the name table
+#define CONFIG_BLOB_NO_BEHAVIOR UINT8_MAX
+
+struct runtime_sensor_rotate_config_blob_header {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t active_profile;
+    uint8_t name_count;
+    uint8_t sensor_count;
+    uint16_t entry_count;
+    uint16_t size;
+    // crc32_ieee of the whole blob with this field zeroed
+    uint32_t crc;
+} __packed;
+
+struct runtime_sensor_rotate_config_blob_sensor {
+    uint8_t sensor_index;
+    uint8_t max_latency_set;
+    // 0 for the default
+    uint16_t resolution;
+    uint16_t max_latency_ms;
+} __packed;
+
+struct runtime_sensor_rotate_config_blob_binding {
+    // Index into the name table
+    uint8_t behavior;
+    uint16_t tap_ms;
+    uint16_t hold_ms;
+    uint32_t param1;
+    uint32_t param2;
+} __packed;
+
+struct runtime_sensor_rotate_config_blob_entry {
+    uint8_t profile;
+    uint8_t sensor_index;
+    uint8_t channel;
+    uint8_t layer;
+    struct runtime_sensor_rotate_acceleration acceleration;
+    struct runtime_sensor_rotate_config_blob_binding cw_binding;
+    struct runtime_sensor_rotate_config_blob_binding ccw_binding;
+} __packed;
+
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_LOCAL_IDS)
+
+// Only accessed with config_lock held
+static const char *config_blob_names[CONFIG_BLOB_NO_BEHAVIOR];
+static zmk_behavior_local_id_t config_blob_local_ids[CONFIG_BLOB_NO_BEHAVIOR];
+static bool config_blob_keep[RUNTIME_SENSOR_ROTATE_MAX_OVERRIDES];
+
+struct config_blob_writer {
+    uint8_t *buf;
+    size_t size;
+    size_t len;
+};
+
+// Append to the blob, only counting the bytes once it doesn't fit anymore
+static void config_blob_write(struct config_blob_writer *writer, const void *data, size_t len) {
+    if (writer->len + len <= writer->size) {
+        memcpy(writer->buf + writer->len, data, len);
+    }
+    writer->len += len;
+}
+
+struct config_blob_reader {
+    const uint8_t *buf;
+    size_t len;
+    size_t pos;
+};
+
+static bool config_blob_read(struct config_blob_reader *reader, void *data, size_t len) {
+    if (reader->len - reader->pos < len) {
+        return false;
+    }
+    memcpy(data, reader->buf + reader->pos, len);
+    reader->pos += len;
+    return true;
+}
+
+// Index of the behavior of a binding in the name table, which it is added to if missing
+static int config_blob_name_index(const struct runtime_sensor_rotate_binding *binding,
+                                  uint8_t *name_count) {
+    if (binding->behavior_local_id == 0) {
+        return CONFIG_BLOB_NO_BEHAVIOR;
+    }
+
+    const char *name = zmk_behavior_find_behavior_name_from_local_id(binding->behavior_local_id);
+    if (!name) {
+        LOG_ERR("Failed to find behavior for local_id %d", binding->behavior_local_id);
+        return -ENOENT;
+    }
+    for (uint8_t i = 0; i < *name_count; i++) {
+        if (strcmp(config_blob_names[i], name) == 0) {
+            return i;
+        }
+    }
+    if (*name_count == CONFIG_BLOB_NO_BEHAVIOR || strlen(name) > UINT8_MAX) {
+        return -ENOMEM;
+    }
+    config_blob_names[*name_count] = name;
+    return (*name_count)++;
+}
+
+static struct runtime_sensor_rotate_config_blob_binding
+to_config_blob_binding(const struct runtime_sensor_rotate_binding *binding, uint8_t *name_count) {
+    return (struct runtime_sensor_rotate_config_blob_binding){
+        .behavior = config_blob_name_index(binding, name_count),
+        .tap_ms = binding->tap_ms,
+        .hold_ms = binding->hold_ms,
+        .param1 = binding->param1,
+        .param2 = binding->param2,
+    };
+}
+
+int zmk_runtime_sensor_rotate_export_config(uint8_t *buf, size_t size) {
+    struct runtime_sensor_rotate_config_blob_header header = {
+        .magic = CONFIG_BLOB_MAGIC,
+        .version = CONFIG_BLOB_VERSION,
+        .sensor_count = ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS,
+    };
+    struct config_blob_writer writer = {.buf = buf, .size = size, .len = sizeof(header)};
+    uint8_t name_count = 0;
+
+    k_mutex_lock(&config_lock, K_FOREVER);
+    header.active_profile = active_profile();
+
+    // The name table precedes the entries, so it is filled in a first pass
+    for (int i = 0; i < RUNTIME_SENSOR_ROTATE_MAX_OVERRIDES; i++) {
+        const struct runtime_sensor_rotate_override *override = &global_data.overrides[i];
+        if (!override->in_use) {
+            continue;
+        }
+        int rc = config_blob_name_index(&override->bindings.cw_binding, &name_count);
+        if (rc >= 0) {
+            rc = config_blob_name_index(&override->bindings.ccw_binding, &name_count);
+        }
+        if (rc < 0) {
+            k_mutex_unlock(&config_lock);
+            return rc;
+        }
+        header.entry_count++;
+    }
+    header.name_count = name_count;
+
+    for (uint8_t i = 0; i < name_count; i++) {
+        uint8_t len = strlen(config_blob_names[i]);
+        config_blob_write(&writer, &len, sizeof(len));
+        config_blob_write(&writer, config_blob_names[i], len);
+    }
+
+    for (uint8_t s = 0; s < ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS; s++) {
+        struct runtime_sensor_rotate_config_blob_sensor sensor = {
+            .sensor_index = s,
+            .max_latency_set = global_data.max_latency_set[s],
+            .resolution = global_data.resolution[s],
+            .max_latency_ms = global_data.max_latency_ms[s],
+        };
+        config_blob_write(&writer, &sensor, sizeof(sensor));
+    }
+
+    for (int i = 0; i < RUNTIME_SENSOR_ROTATE_MAX_OVERRIDES; i++) {
+        const struct runtime_sensor_rotate_override *override = &global_data.overrides[i];
+        if (!override->in_use) {
+            continue;
+        }
+        struct runtime_sensor_rotate_config_blob_entry entry = {
+            .profile = override->profile,
+            .sensor_index = override->sensor_index,
+            .channel = override->channel,
+            .layer = override->layer,
+            .acceleration = override->acceleration,
+            .cw_binding = to_config_blob_binding(&override->bindings.cw_binding, &name_count),
+            .ccw_binding = to_config_blob_binding(&override->bindings.ccw_binding, &name_count),
+        };
+        config_blob_write(&writer, &entry, sizeof(entry));
+    }
+    k_mutex_unlock(&config_lock);
+
+    if (writer.len > size || writer.len > UINT16_MAX) {
+        LOG_ERR("Configuration needs %zu bytes, only %zu available", writer.len, size);
+        return -ENOMEM;
+    }
+
+    header.size = writer.len;
+    memcpy(buf, &header, sizeof(header));
+    header.crc = crc32_ieee(buf, writer.len);
+    memcpy(buf, &header, sizeof(header));
+    return writer.len;
+}
+
+static bool from_config_blob_binding(const struct runtime_sensor_rotate_config_blob_binding *in,
+                                     uint8_t name_count,
+                                     struct runtime_sensor_rotate_binding *out) {
+    *out = (struct runtime_sensor_rotate_binding){};
+    if (in->behavior == CONFIG_BLOB_NO_BEHAVIOR) {
+        return true;
+    }
+    if (in->behavior >= name_count) {
+        return false;
+    }
+    *out = (struct runtime_sensor_rotate_binding){
+        .behavior_local_id = config_blob_local_ids[in->behavior],
+        .tap_ms = in->tap_ms,
+        .hold_ms = in->hold_ms,
+        .param1 = in->param1,
+        .param2 = in->param2,
+    };
+    return true;
+}
+
+// Check the sections after the header and look the behavior names up. Leaves the reader at the
+// end of the blob.
+static int validate_config_blob(struct config_blob_reader *reader,
+                                const struct runtime_sensor_rotate_config_blob_header *header) {
+    for (uint8_t i = 0; i < header->name_count; i++) {
+        char name[UINT8_MAX + 1];
+        uint8_t len;
+        if (!config_blob_read(reader, &len, sizeof(len)) || !config_blob_read(reader, name, len)) {
+            return -EINVAL;
+        }
+        name[len] = '\0';
+        config_blob_local_ids[i] = zmk_behavior_get_local_id(name);
+        if (config_blob_local_ids[i] == UINT16_MAX) {
+            LOG_ERR("Configuration blob binds behavior %s, which this firmware doesn't have", name);
+            return -ENOENT;
+        }
+    }
+
+    for (uint8_t i = 0; i < header->sensor_count; i++) {
+        struct runtime_sensor_rotate_config_blob_sensor sensor;
+        if (!config_blob_read(reader, &sensor, sizeof(sensor))) {
+            return -EINVAL;
+        }
+        if (sensor.sensor_index >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS ||
+            (sensor.resolution != 0 &&
+             (sensor.resolution < ZMK_RUNTIME_SENSOR_ROTATE_MIN_RESOLUTION ||
+              sensor.resolution > ZMK_RUNTIME_SENSOR_ROTATE_MAX_RESOLUTION))) {
+            LOG_ERR("Invalid tuning of sensor %d in configuration blob", sensor.sensor_index);
+            return -EINVAL;
+        }
+    }
+
+    if (header->entry_count > RUNTIME_SENSOR_ROTATE_MAX_OVERRIDES) {
+        LOG_ERR("Configuration blob has %d overrides, increase "
+                "CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_MAX_OVERRIDES",
+                header->entry_count);
+        return -ENOMEM;
+    }
+    for (uint16_t i = 0; i < header->entry_count; i++) {
+        struct runtime_sensor_rotate_config_blob_entry entry;
+        struct runtime_sensor_rotate_binding binding;
+        if (!config_blob_read(reader, &entry, sizeof(entry))) {
+            return -EINVAL;
+        }
+        if (entry.profile >= ZMK_RUNTIME_SENSOR_ROTATE_PROFILES ||
+            entry.sensor_index >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS ||
+            entry.channel >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_CHANNELS ||
+            entry.layer >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS ||
+            !from_config_blob_binding(&entry.cw_binding, header->name_count, &binding) ||
+            !from_config_blob_binding(&entry.ccw_binding, header->name_count, &binding)) {
+            LOG_ERR("Invalid override of profile %d sensor %d channel %d layer %d in "
+                    "configuration blob",
+                    entry.profile, entry.sensor_index, entry.channel, entry.layer);
+            return -EINVAL;
+        }
+    }
+
+    if (header->active_profile >= ZMK_RUNTIME_SENSOR_ROTATE_PROFILES ||
+        reader->pos != reader->len) {
+        return -EINVAL;
+    }
+    return 0;
+}
+
+// Replace all overrides with the entries of a validated blob. Overrides the blob keeps are
+// updated in place, the others go back to the defaults first to free their slots.
+static void
+import_config_blob_entries(struct config_blob_reader *reader,
+                           const struct runtime_sensor_rotate_config_blob_header *header) {
+    size_t entries_pos = reader->pos;
+    struct runtime_sensor_rotate_config_blob_entry entry;
+
+    memset(config_blob_keep, 0, sizeof(config_blob_keep));
+    for (uint16_t i = 0; i < header->entry_count; i++) {
+        config_blob_read(reader, &entry, sizeof(entry));
+        struct runtime_sensor_rotate_override *override =
+            find_override(entry.profile, entry.sensor_index, entry.channel, entry.layer);
+        if (override) {
+            config_blob_keep[override - global_data.overrides] = true;
+        }
+    }
+    for (int i = 0; i < RUNTIME_SENSOR_ROTATE_MAX_OVERRIDES; i++) {
+        struct runtime_sensor_rotate_override *override = &global_data.overrides[i];
+        if (!override->in_use || config_blob_keep[i]) {
+            continue;
+        }
+        atomic_set_bit(global_data.dirty, SETTINGS_BIT(override->profile, override->sensor_index,
+                                                       override->channel, override->layer));
+        override->bindings = (struct runtime_sensor_rotate_layer_bindings){};
+        override->acceleration = (struct runtime_sensor_rotate_acceleration){};
+        release_override_if_unused(override);
+    }
 
-        LOG_DBG("Loaded bindings for sensor %d layer %d", sensor_index, layer);
-        return 0;
+    reader->pos = entries_pos;
+    for (uint16_t i = 0; i < header->entry_count; i++) {
+        config_blob_read(reader, &entry, sizeof(entry));
+        // Can't run out, there are no more entries than slots and all others were freed
+        struct runtime_sensor_rotate_override *override =
+            find_or_alloc_override(entry.profile, entry.sensor_index, entry.channel, entry.layer);
+        if (!override) {
+            continue;
+        }
+        from_config_blob_binding(&entry.cw_binding, header->name_count,
+                                 &override->bindings.cw_binding);
+        from_config_blob_binding(&entry.ccw_binding, header->name_count,
+                                 &override->bindings.ccw_binding);
+        override->acceleration = entry.acceleration;
+        atomic_set_bit(global_data.dirty, SETTINGS_BIT(entry.profile, entry.sensor_index,
+                                                       entry.channel, entry.layer));
     }
 
-    return -ENOENT;
+    // Published once all entries are in, like a batch of zmk_runtime_sensor_rotate_apply_updates
+    for (int i = 0; i < RUNTIME_SENSOR_ROTATE_MAX_OVERRIDES; i++) {
+        struct runtime_sensor_rotate_override *override = &global_data.overrides[i];
+        if (override->in_use) {
+            publish_override(override);
+            release_override_if_unused(override);
+        }
+    }
 }
 
-SETTINGS_STATIC_HANDLER_DEFINE(behavior_runtime_sensor_rotate, SETTINGS_KEY, NULL, settings_set,
-                               NULL, NULL);
-
-int zmk_runtime_sensor_rotate_get_layer_bindings(
-    uint8_t sensor_index, uint8_t layer, struct runtime_sensor_rotate_layer_bindings *bindings) {
-
-    if (sensor_index >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS) {
-        return -EINVAL;
-    }
-    if (layer >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS) {
-        return -EINVAL;
+// Per-sensor tuning of a validated blob, sensors it doesn't list go back to the defaults
+static void
+import_config_blob_sensors(struct config_blob_reader *reader,
+                           const struct runtime_sensor_rotate_config_blob_header *header) {
+    memset(global_data.resolution, 0, sizeof(global_data.resolution));
+    memset(global_data.max_latency_set, 0, sizeof(global_data.max_latency_set));
+    for (uint8_t i = 0; i < header->sensor_count; i++) {
+        struct runtime_sensor_rotate_config_blob_sensor sensor;
+        config_blob_read(reader, &sensor, sizeof(sensor));
+        global_data.resolution[sensor.sensor_index] = sensor.resolution;
+        global_data.max_latency_ms[sensor.sensor_index] = sensor.max_latency_ms;
+        global_data.max_latency_set[sensor.sensor_index] = sensor.max_latency_set;
     }
 
-    *bindings = global_data.bindings[sensor_index][layer];
-    return 0;
+    for (uint8_t s = 0; s < ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS; s++) {
+        atomic_set_bit(global_data.tuning_dirty, s);
+        bump_generation(s);
+    }
 }
 
-int zmk_runtime_sensor_rotate_set_layer_bindings(
-    uint8_t sensor_index, uint8_t layer,
-    const struct runtime_sensor_rotate_layer_bindings *bindings) {
+int zmk_runtime_sensor_rotate_import_config(const uint8_t *buf, size_t len) {
+    struct runtime_sensor_rotate_config_blob_header header;
+    struct config_blob_reader reader = {.buf = buf, .len = len};
 
-    if (sensor_index >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS) {
+    if (!config_blob_read(&reader, &header, sizeof(header)) || header.magic != CONFIG_BLOB_MAGIC ||
+        header.size != len) {
+        LOG_ERR("Not a configuration blob");
         return -EINVAL;
     }
-    if (layer >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS) {
+    if (header.version != CONFIG_BLOB_VERSION) {
+        LOG_ERR("Unsupported configuration blob version %d", header.version);
         return -EINVAL;
     }
+    uint32_t crc = header.crc;
+    header.crc = 0;
+    if (crc32_ieee_update(crc32_ieee((const uint8_t *)&header, sizeof(header)),
+                          buf + sizeof(header), len - sizeof(header)) != crc) {
+        LOG_ERR("Configuration blob checksum mismatch");
+        return -EBADMSG;
+    }
 
-    global_data.bindings[sensor_index][layer] = *bindings;
-
-    // Save to settings with per-sensor, per-layer key
-    char key[32];
-    snprintf(key, sizeof(key), SETTINGS_KEY "/s%d/l%d", sensor_index, layer);
-
-    int rc = settings_save_one(key, &global_data.bindings[sensor_index][layer],
-                               sizeof(struct runtime_sensor_rotate_layer_bindings));
+    k_mutex_lock(&config_lock, K_FOREVER);
+    int rc = validate_config_blob(&reader, &header);
     if (rc != 0) {
-        LOG_ERR("Failed to save settings for sensor %d layer %d: %d", sensor_index, layer, rc);
+        k_mutex_unlock(&config_lock);
+        LOG_ERR("Invalid configuration blob: %d", rc);
+        return rc;
+    }
+    // The save pass below can't run without a settings backend
+    void *storage;
+    rc = settings_storage_get(&storage);
+    if (rc != 0) {
+        k_mutex_unlock(&config_lock);
+        LOG_ERR("No settings storage to import into: %d", rc);
         return rc;
     }
 
-    LOG_DBG("Saved bindings (local_id=%d) for sensor %d layer %d",
-            bindings->cw_binding.behavior_local_id, sensor_index, layer);
-    return 0;
+    // Nothing has changed so far, from here on the whole blob is applied
+    reader.pos = sizeof(header);
+    for (uint8_t i = 0; i < header.name_count; i++) {
+        uint8_t name_len;
+        config_blob_read(&reader, &name_len, sizeof(name_len));
+        reader.pos += name_len;
+    }
+    import_config_blob_sensors(&reader, &header);
+    import_config_blob_entries(&reader, &header);
+    zmk_runtime_sensor_rotate_set_active_profile(header.active_profile);
+    bump_global_generation();
+
+    // All changes go out in a single save pass. Whatever it fails to write stays dirty and is
+    // retried by the next one.
+    k_work_cancel_delayable(&save_work);
+    rc = save_dirty();
+    if (rc != 0) {
+        k_work_reschedule(&save_work,
+                          K_MSEC(CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_SETTINGS_SAVE_DEBOUNCE));
+    }
+    k_mutex_unlock(&config_lock);
+
+    LOG_INF("Imported %d overrides of %d behaviors", header.entry_count, header.name_count);
+    return rc;
 }
 
+#else
+
+int zmk_runtime_sensor_rotate_export_config(uint8_t *buf, size_t size) { return -ENOTSUP; }
+
+int zmk_runtime_sensor_rotate_import_config(const uint8_t *buf, size_t len) { return -ENOTSUP; }
+
+#endif
+
 int zmk_runtime_sensor_rotate_get_all_layer_bindings(
     uint8_t sensor_index, uint8_t max_layers,
     struct runtime_sensor_rotate_layer_bindings *bindings_array, uint8_t *actual_layers) {
@@ -170,216 +2189,741 @@ int zmk_runtime_sensor_rotate_get_all_layer_bindings(
     return 0;
 }
 
-int zmk_runtime_sensor_rotate_get_bindings(uint8_t sensor_index, uint8_t layer_index,
-                                           struct runtime_sensor_rotate_layer_bindings *out) {
+static void fill_default_binding(const struct runtime_sensor_rotate_resolved_binding *resolved,
+                                 struct runtime_sensor_rotate_binding *out) {
+    if (resolved->behavior_dev == NULL) {
+        // No default for this direction
+        return;
+    }
+    *out = (struct runtime_sensor_rotate_binding){
+        .behavior_local_id = resolved->behavior_local_id,
+        .param1 = resolved->param1,
+        .param2 = resolved->param2,
+        .tap_ms = resolved->tap_ms,
+        .hold_ms = resolved->hold_ms,
+    };
+}
+
+int zmk_runtime_sensor_rotate_get_channel_bindings(
+    uint8_t sensor_index, uint8_t channel, uint8_t layer_index,
+    struct runtime_sensor_rotate_layer_bindings *out) {
     if (sensor_index >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS) {
         return -EINVAL;
     }
+    if (channel >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_CHANNELS) {
+        return -EINVAL;
+    }
     if (layer_index >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS) {
         return -EINVAL;
     }
     // set from runtime first
-    *out = global_data.bindings[sensor_index][layer_index];
-    // If not set, fill from default
-    if (out->cw_binding.behavior_local_id == 0 || out->ccw_binding.behavior_local_id == 0) {
-#if ZMK_KEYMAP_HAS_SENSORS
-        if (global_default_behavior_dev[layer_index][sensor_index] != NULL) {
-            const struct device *dev =
-                zmk_behavior_get_binding(global_default_behavior_dev[layer_index][sensor_index]);
-            if (dev) {
-                const struct behavior_runtime_sensor_rotate_config *config = dev->config;
-                if (out->cw_binding.behavior_local_id == 0 &&
-                    config->default_cw_binding_name != NULL) {
-                    out->cw_binding.behavior_local_id =
-                        zmk_behavior_get_local_id(config->default_cw_binding_name);
-                    out->cw_binding.param1 = config->default_cw_binding_params.param1;
-                    out->cw_binding.param2 = config->default_cw_binding_params.param2;
-                    out->cw_binding.tap_ms = config->default_cw_binding_params.tap_ms;
-                }
-                if (out->ccw_binding.behavior_local_id == 0 &&
-                    config->default_ccw_binding_name != NULL) {
-                    out->ccw_binding.behavior_local_id =
-                        zmk_behavior_get_local_id(config->default_ccw_binding_name);
-                    out->ccw_binding.param1 = config->default_ccw_binding_params.param1;
-                    out->ccw_binding.param2 = config->default_ccw_binding_params.param2;
-                    out->ccw_binding.tap_ms = config->default_ccw_binding_params.tap_ms;
-                }
-            } else {
-                LOG_ERR("Behavior device not found: %s",
-                        global_default_behavior_dev[layer_index][sensor_index]);
+    k_mutex_lock(&config_lock, K_FOREVER);
+    const struct runtime_sensor_rotate_override *override =
+        find_override(active_profile(), sensor_index, channel, layer_index);
+    *out = override ? override->bindings : (struct runtime_sensor_rotate_layer_bindings){};
+    k_mutex_unlock(&config_lock);
+    // If not set, fill from default, which only channel 0 has
+    if (channel == 0 &&
+        (out->cw_binding.behavior_local_id == 0 || out->ccw_binding.behavior_local_id == 0)) {
+        if (!global_data.default_slots_initialized) {
+            init_default_slots();
+        }
+        uint8_t slot = global_data.default_slot[sensor_index][layer_index];
+        if (slot) {
+            const struct runtime_sensor_rotate_resolved_layer_bindings *defaults =
+                &global_data.defaults[slot - 1];
+            if (out->cw_binding.behavior_local_id == 0) {
+                fill_default_binding(&defaults->cw_binding, &out->cw_binding);
+            }
+            if (out->ccw_binding.behavior_local_id == 0) {
+                fill_default_binding(&defaults->ccw_binding, &out->ccw_binding);
             }
         }
-#endif
     }
     return 0;
 }
 
-static int behavior_runtime_sensor_rotate_accept_data(
-    struct zmk_behavior_binding *binding, struct zmk_behavior_binding_event event,
-    const struct zmk_sensor_config *sensor_config, size_t channel_data_size,
-    const struct zmk_sensor_channel_data *channel_data) {
+int zmk_runtime_sensor_rotate_get_bindings(uint8_t sensor_index, uint8_t layer_index,
+                                           struct runtime_sensor_rotate_layer_bindings *out) {
+    return zmk_runtime_sensor_rotate_get_channel_bindings(sensor_index, 0, layer_index, out);
+}
 
-    const struct sensor_value value = channel_data[0].value;
-    int triggers;
-    int sensor_index = ZMK_SENSOR_POSITION_FROM_VIRTUAL_KEY_POSITION(event.position);
+static struct zmk_behavior_binding
+to_behavior_binding(const struct runtime_sensor_rotate_resolved_binding *resolved) {
+    return (struct zmk_behavior_binding){
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_LOCAL_IDS_IN_BINDINGS)
+        .local_id = resolved->behavior_local_id,
+#endif
+        .behavior_dev = resolved->behavior_dev,
+        .param1 = resolved->param1,
+        .param2 = resolved->param2,
+    };
+}
 
-    if (sensor_index >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS) {
-        LOG_ERR("Sensor index %d out of bounds", sensor_index);
-        return -EINVAL;
+static inline void stats_tap_ms(uint8_t sensor_index, uint8_t layer, uint16_t tap_ms,
+                                bool shortened);
+
+// tap-ms for a burst of taps, shortened when needed to play back the burst within the maximum
+// latency of the sensor. Never below the floor, unless the binding's own tap-ms is.
+static uint16_t bound_tap_ms(uint8_t sensor_index, uint16_t tap_ms, int taps) {
+    uint16_t max_latency_ms = get_max_latency(sensor_index);
+    if (max_latency_ms == 0 || (uint32_t)tap_ms * taps <= max_latency_ms) {
+        return tap_ms;
+    }
+    return MAX(max_latency_ms / taps, MIN(CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_MIN_TAP_MS, tap_ms));
+}
+
+static void coalesce_work_handler(struct k_work *work) {
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct runtime_sensor_rotate_coalesce_state *state =
+        CONTAINER_OF(dwork, struct runtime_sensor_rotate_coalesce_state, work);
+    int64_t now = k_uptime_get();
+
+    k_spinlock_key_t key = k_spin_lock(&state->lock);
+    bool release = state->pressed;
+    if (release && state->release_at > now) {
+        // Run before the press lasted tap-ms
+        int64_t remaining = state->release_at - now;
+        k_spin_unlock(&state->lock, key);
+        k_work_reschedule(dwork, K_MSEC(remaining));
+        return;
+    }
+    if (!release && state->pending == 0) {
+        k_spin_unlock(&state->lock, key);
+        return;
+    }
+    if (!release) {
+        state->active_binding = state->pending_binding;
+        state->active_event = state->pending_event;
+        state->pending += state->pending > 0 ? -1 : 1;
+        state->release_at = now + state->active_binding.tap_ms;
     }
+    state->pressed = !release;
+    struct zmk_behavior_binding binding = to_behavior_binding(&state->active_binding);
+    struct zmk_behavior_binding_event event = state->active_event;
+    uint32_t tap_ms = state->active_binding.tap_ms;
+    bool more = state->pending != 0;
+    k_spin_unlock(&state->lock, key);
+
+    // Invoked from the system work queue rather than through the behavior queue, see the
+    // coalesce property of the binding
+    event.timestamp = now;
+    zmk_behavior_invoke_binding(&binding, event, !release);
+
+    if (!release) {
+        // Replaces any earlier schedule, so that the press always lasts tap-ms
+        k_work_reschedule(dwork, K_MSEC(tap_ms));
+    } else if (more) {
+        k_work_schedule(dwork, K_NO_WAIT);
+    }
+}
 
-    // Check if we already accepted data for this sensor/layer combination
-    if (global_data.data_accepted[sensor_index][event.layer]) {
-        LOG_DBG("Already accepted data for sensor %d layer %d", sensor_index, event.layer);
-        return 0;
+static void coalesce_triggers(uint8_t sensor_index, uint8_t channel, uint16_t max_pending,
+                              const struct runtime_sensor_rotate_resolved_binding *binding,
+                              const struct zmk_behavior_binding_event *event, int triggers) {
+    struct runtime_sensor_rotate_coalesce_state *state =
+        &global_data.coalesce[SENSOR_CHANNEL(sensor_index, channel)];
+
+    uint16_t tap_ms = 0;
+
+    k_spinlock_key_t key = k_spin_lock(&state->lock);
+    int pending = CLAMP(state->pending + triggers, -(int)max_pending, (int)max_pending);
+    // Opposite directions cancel out. The binding is only replaced when the new direction wins,
+    // with tap-ms bound for all the taps pending. Losing only leaves fewer taps to play back.
+    if ((pending > 0 && triggers > 0) || (pending < 0 && triggers < 0)) {
+        tap_ms = bound_tap_ms(sensor_index, binding->tap_ms, pending > 0 ? pending : -pending);
+        state->pending_binding = *binding;
+        state->pending_binding.tap_ms = tap_ms;
+        state->pending_event = *event;
     }
+    if (pending != state->pending + triggers) {
+        LOG_DBG("Sensor %d channel %d: dropped %d coalesced triggers", sensor_index, channel,
+                state->pending + triggers - pending);
+    }
+    state->pending = pending;
+    // While a press is held, its release picks up the pending taps
+    bool schedule = pending != 0 && !state->pressed;
+    k_spin_unlock(&state->lock, key);
 
-    // Mark as accepted to prevent duplicate processing
-    global_data.data_accepted[sensor_index][event.layer] = true;
+    if (tap_ms != 0) {
+        stats_tap_ms(sensor_index, event->layer, tap_ms, tap_ms != binding->tap_ms);
+    }
+    if (schedule) {
+        // No-op while the work item is already scheduled
+        k_work_schedule(&state->work, K_NO_WAIT);
+    }
+}
 
-    // Same logic as behavior_sensor_rotate_common
-    if (value.val1 == 0) {
-        triggers = value.val2;
-    } else {
-        struct sensor_value remainder = global_data.remainder[sensor_index][event.layer];
+static bool same_binding(const struct runtime_sensor_rotate_resolved_binding *a,
+                         const struct runtime_sensor_rotate_resolved_binding *b) {
+    return a->param1 == b->param1 && a->param2 == b->param2 &&
+           strcmp(a->behavior_dev, b->behavior_dev) == 0;
+}
 
-        remainder.val1 += value.val1;
-        remainder.val2 += value.val2;
+// Clear the held binding and return it for release, if any. Callers hold the lock.
+static bool hold_take_locked(struct runtime_sensor_rotate_hold_state *state,
+                             struct zmk_behavior_binding *binding,
+                             struct zmk_behavior_binding_event *event) {
+    if (state->direction == 0) {
+        return false;
+    }
+    *binding = to_behavior_binding(&state->binding);
+    *event = state->event;
+    state->direction = 0;
+    return true;
+}
 
-        if (remainder.val2 >= 1000000 || remainder.val2 <= -1000000) {
-            remainder.val1 += remainder.val2 / 1000000;
-            remainder.val2 %= 1000000;
-        }
+static void hold_queue_release(struct zmk_behavior_binding *binding,
+                               struct zmk_behavior_binding_event *event) {
+    event->timestamp = k_uptime_get();
+    zmk_behavior_queue_add(event, *binding, false, 0);
+}
 
-        int trigger_degrees = 360 / sensor_config->triggers_per_rotation;
-        triggers = remainder.val1 / trigger_degrees;
-        remainder.val1 %= trigger_degrees;
+static void hold_work_handler(struct k_work *work) {
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct runtime_sensor_rotate_hold_state *state =
+        CONTAINER_OF(dwork, struct runtime_sensor_rotate_hold_state, work);
+    struct zmk_behavior_binding binding;
+    struct zmk_behavior_binding_event event;
+
+    k_spinlock_key_t key = k_spin_lock(&state->lock);
+    int64_t remaining = state->release_at - k_uptime_get();
+    if (state->direction != 0 && remaining > 0) {
+        k_spin_unlock(&state->lock, key);
+        k_work_schedule(dwork, K_MSEC(remaining));
+        return;
+    }
+    bool release = hold_take_locked(state, &binding, &event);
+    k_spin_unlock(&state->lock, key);
 
-        global_data.remainder[sensor_index][event.layer] = remainder;
+    if (release) {
+        hold_queue_release(&binding, &event);
     }
+}
 
-    LOG_DBG("Sensor %d layer %d: val1=%d val2=%d remainder=%d/%d triggers=%d", sensor_index,
-            event.layer, value.val1, value.val2,
-            global_data.remainder[sensor_index][event.layer].val1,
-            global_data.remainder[sensor_index][event.layer].val2, triggers);
+// Press the binding on the first trigger and keep it held while triggers in the same direction
+// arrive. A different binding or direction releases the held one first.
+static void hold_triggers(uint8_t sensor_index, uint8_t channel,
+                          const struct runtime_sensor_rotate_resolved_binding *binding,
+                          const struct zmk_behavior_binding_event *event, int triggers) {
+    struct runtime_sensor_rotate_hold_state *state =
+        &global_data.hold[SENSOR_CHANNEL(sensor_index, channel)];
+    int8_t direction = triggers > 0 ? 1 : -1;
+    struct zmk_behavior_binding released;
+    struct zmk_behavior_binding_event released_event;
+    bool release = false;
+
+    k_spinlock_key_t key = k_spin_lock(&state->lock);
+    bool press = state->direction != direction || !same_binding(&state->binding, binding);
+    if (press) {
+        release = hold_take_locked(state, &released, &released_event);
+        state->binding = *binding;
+        state->event = *event;
+        state->direction = direction;
+    }
+    // Far enough ahead that the work item can't release the new press before it is queued below
+    state->release_at = k_uptime_get() + binding->hold_ms;
+    k_spin_unlock(&state->lock, key);
 
-    global_data.triggers[sensor_index][event.layer] = triggers;
-    return 0;
+    if (release) {
+        hold_queue_release(&released, &released_event);
+    }
+    if (press) {
+        zmk_behavior_queue_add(event, to_behavior_binding(binding), true, 0);
+    }
+    // No-op while already scheduled, the work item catches up with release_at
+    k_work_schedule(&state->work, K_MSEC(binding->hold_ms));
 }
 
-static int behavior_runtime_sensor_rotate_process(struct zmk_behavior_binding *binding,
-                                                  struct zmk_behavior_binding_event event,
-                                                  enum behavior_sensor_binding_process_mode mode) {
+// Release a binding held on the sensor channel before anything else is triggered on it
+static void hold_release(uint8_t sensor_index, uint8_t channel) {
+    struct runtime_sensor_rotate_hold_state *state =
+        &global_data.hold[SENSOR_CHANNEL(sensor_index, channel)];
+    struct zmk_behavior_binding binding;
+    struct zmk_behavior_binding_event event;
 
-    const int sensor_index = ZMK_SENSOR_POSITION_FROM_VIRTUAL_KEY_POSITION(event.position);
+    // Only written with the lock held, a stale read is settled under it or by the work item
+    if (state->direction == 0) {
+        return;
+    }
+    k_spinlock_key_t key = k_spin_lock(&state->lock);
+    bool release = hold_take_locked(state, &binding, &event);
+    k_spin_unlock(&state->lock, key);
 
-    if (sensor_index >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS) {
-        LOG_ERR("Sensor index %d out of bounds", sensor_index);
-        return -EINVAL;
+    if (release) {
+        hold_queue_release(&binding, &event);
     }
+}
 
-    if (mode != BEHAVIOR_SENSOR_BINDING_PROCESS_MODE_TRIGGER) {
-        // Reset triggers and accepted flag
-        global_data.triggers[sensor_index][event.layer] = 0;
-        global_data.data_accepted[sensor_index][event.layer] = false;
-        return ZMK_BEHAVIOR_TRANSPARENT;
+static int apply_acceleration(uint8_t sensor_index, uint8_t channel, uint8_t layer, int triggers) {
+    struct runtime_sensor_rotate_snapshot snapshot;
+    if (triggers == 0 || !read_override(sensor_index, channel, layer, &snapshot)) {
+        return triggers;
+    }
+
+    const struct runtime_sensor_rotate_acceleration *accel = &snapshot.acceleration;
+    if (accel->threshold_ms == 0) {
+        return triggers;
     }
 
-    int triggers = global_data.triggers[sensor_index][event.layer];
+    uint32_t interval = global_data.event_interval_ms[sensor_index];
+    int factor = 100;
+    if (interval < accel->threshold_ms && accel->multiplier > 100) {
+        factor += (accel->multiplier - 100) * (int)(accel->threshold_ms - interval) /
+                  accel->threshold_ms;
+    }
 
-    // Reset accepted flag after processing
-    global_data.data_accepted[sensor_index][event.layer] = false;
+    // Less than a trigger, so it isn't worth resetting when the curve changes
+    int16_t *remainder =
+        &global_data.acceleration_remainder[SENSOR_CHANNEL(sensor_index, channel)][layer];
+    int scaled = triggers * factor + *remainder;
+    int result = scaled / 100;
+    *remainder = scaled % 100;
 
-    if (event.layer >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS) {
-        LOG_WRN("Layer %d exceeds max layers, skipping", event.layer);
-        return ZMK_BEHAVIOR_TRANSPARENT;
+    if (accel->max_triggers > 0) {
+        result = CLAMP(result, -(int)accel->max_triggers, (int)accel->max_triggers);
+    }
+    return result;
+}
+
+#if IS_ENABLED(CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_STATS)
+
+// Only updated from the keymap event path, readers may see slightly stale values
+static inline struct runtime_sensor_rotate_stats *get_stats(uint8_t sensor_index, uint8_t layer) {
+    if (sensor_index >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS ||
+        layer >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS) {
+        return &global_data.untracked_stats;
     }
+    return &global_data.stats[sensor_index][layer];
+}
 
-    struct runtime_sensor_rotate_binding triggered_binding_data;
-    // Check runtime bindings
+static inline void stats_event_accepted(uint8_t sensor_index, uint8_t layer) {
+    get_stats(sensor_index, layer)->events_accepted++;
+}
+
+static inline void stats_triggered(uint8_t sensor_index, uint8_t layer, int triggers) {
+    struct runtime_sensor_rotate_stats *stats = get_stats(sensor_index, layer);
+    uint32_t count = triggers < 0 ? -triggers : triggers;
     if (triggers > 0) {
-        triggered_binding_data = global_data.bindings[sensor_index][event.layer].cw_binding;
-    } else if (triggers < 0) {
-        triggered_binding_data = global_data.bindings[sensor_index][event.layer].ccw_binding;
+        stats->cw_triggers += count;
     } else {
-        return ZMK_BEHAVIOR_TRANSPARENT;
+        stats->ccw_triggers += count;
     }
-    const char *behavior_name = NULL;
-    if (triggered_binding_data.behavior_local_id == 0) {
-        // Check default bindings
-        const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
-        if (!dev) {
-            LOG_ERR("Behavior device not found: %s", binding->behavior_dev);
-            return ZMK_BEHAVIOR_TRANSPARENT;
-        }
-        const struct behavior_runtime_sensor_rotate_config *config = dev->config;
-        if (triggers > 0 && config->default_cw_binding_name != NULL) {
-            behavior_name = config->default_cw_binding_name;
-#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_LOCAL_IDS_IN_BINDINGS)
-            triggered_binding_data.behavior_local_id = zmk_behavior_get_local_id(behavior_name);
+    stats->max_triggers_per_event = MAX(stats->max_triggers_per_event, count);
+}
+
+static inline void stats_transparent(uint8_t sensor_index, uint8_t layer) {
+    get_stats(sensor_index, layer)->transparent++;
+}
+
+static inline void stats_lookup_failed(uint8_t sensor_index, uint8_t layer) {
+    get_stats(sensor_index, layer)->lookup_failures++;
+}
+
+static inline void stats_tap_ms(uint8_t sensor_index, uint8_t layer, uint16_t tap_ms,
+                                bool shortened) {
+    struct runtime_sensor_rotate_stats *stats = get_stats(sensor_index, layer);
+    if (shortened) {
+        stats->shortened_events++;
+    }
+    stats->min_tap_ms = stats->tap_bursts == 0 ? tap_ms : MIN(stats->min_tap_ms, tap_ms);
+    stats->last_tap_ms = tap_ms;
+    stats->tap_bursts++;
+}
+
+static inline uint32_t stats_process_start(void) { return k_cycle_get_32(); }
+
+static inline void stats_process_done(uint8_t sensor_index, uint8_t layer, uint32_t start) {
+    struct runtime_sensor_rotate_stats *stats = get_stats(sensor_index, layer);
+    uint32_t cycles = k_cycle_get_32() - start;
+    stats->process_count++;
+    stats->process_cycles_total += cycles;
+    stats->process_cycles_max = MAX(stats->process_cycles_max, cycles);
+}
+
+int zmk_runtime_sensor_rotate_get_stats(uint8_t sensor_index, uint8_t layer,
+                                        struct runtime_sensor_rotate_stats *out) {
+    if (sensor_index >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS) {
+        return -EINVAL;
+    }
+    if (layer >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS) {
+        return -EINVAL;
+    }
+    *out = *get_stats(sensor_index, layer);
+    return 0;
+}
+
+void zmk_runtime_sensor_rotate_reset_stats(void) {
+    memset(global_data.stats, 0, sizeof(global_data.stats));
+}
+
+#else
+
+static inline void stats_event_accepted(uint8_t sensor_index, uint8_t layer) {}
+static inline void stats_triggered(uint8_t sensor_index, uint8_t layer, int triggers) {}
+static inline void stats_transparent(uint8_t sensor_index, uint8_t layer) {}
+static inline void stats_lookup_failed(uint8_t sensor_index, uint8_t layer) {}
+static inline void stats_tap_ms(uint8_t sensor_index, uint8_t layer, uint16_t tap_ms,
+                                bool shortened) {}
+static inline uint32_t stats_process_start(void) { return 0; }
+static inline void stats_process_done(uint8_t sensor_index, uint8_t layer, uint32_t start) {}
+
 #endif
-            triggered_binding_data.param1 = config->default_cw_binding_params.param1;
-            triggered_binding_data.param2 = config->default_cw_binding_params.param2;
-            triggered_binding_data.tap_ms = config->default_cw_binding_params.tap_ms;
-        } else if (triggers < 0 && config->default_ccw_binding_name != NULL) {
-            behavior_name = config->default_ccw_binding_name;
-#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_LOCAL_IDS_IN_BINDINGS)
-            triggered_binding_data.behavior_local_id = zmk_behavior_get_local_id(behavior_name);
+
+#if IS_ENABLED(CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_EVENT_LOG)
+
+#define EVENT_LOG_SIZE CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_EVENT_LOG_SIZE
+// Recording stops this long after the last drain, once no client reads the events anymore
+#define EVENT_LOG_IDLE_MS 3000
+
+// Written from the keymap event path and read from the Studio RPC thread
+static struct k_spinlock event_log_lock;
+static struct runtime_sensor_rotate_event_record event_log[EVENT_LOG_SIZE];
+// Sequence number of the next record
+static uint32_t event_log_sequence;
+// Truncated uptime until which events are recorded, extended by every drain
+static atomic_t event_log_until;
+// Raw value of the current event per sensor channel, kept by accept_data while recording
+static struct sensor_value event_log_values[RUNTIME_SENSOR_ROTATE_SENSOR_CHANNELS];
+
+static inline bool event_log_active(int64_t timestamp) {
+    return (int32_t)((uint32_t)atomic_get(&event_log_until) - (uint32_t)timestamp) > 0;
+}
+
+static inline void event_log_keep_value(uint8_t sensor_index, uint8_t channel,
+                                        const struct zmk_behavior_binding_event *event,
+                                        const struct sensor_value *value) {
+    if (event_log_active(event->timestamp)) {
+        event_log_values[SENSOR_CHANNEL(sensor_index, channel)] = *value;
+    }
+}
+
+// Record how a layer handled a sensor channel event, with the binding played if any
+static void event_log_record(uint8_t sensor_index, uint8_t channel,
+                             const struct zmk_behavior_binding_event *event, int triggers,
+                             bool transparent,
+                             const struct runtime_sensor_rotate_resolved_binding *binding) {
+    if (!event_log_active(event->timestamp)) {
+        return;
+    }
+
+    int sc = SENSOR_CHANNEL(sensor_index, channel);
+    struct runtime_sensor_rotate_event_record record = {
+        .timestamp_ms = (uint32_t)event->timestamp,
+        .val1 = event_log_values[sc].val1,
+        .val2 = event_log_values[sc].val2,
+        .remainder_milli = (int32_t)(global_data.channels[sc].remainder * 1000 /
+                                     RSR_ACCUMULATOR_UNITS_PER_TRIGGER),
+        .triggers = CLAMP(triggers, INT16_MIN, INT16_MAX),
+        .sensor_index = sensor_index,
+        .channel = channel,
+        .layer = event->layer,
+        .transparent = transparent,
+    };
+    if (binding != NULL) {
+        record.binding = (struct runtime_sensor_rotate_binding){
+            .behavior_local_id = binding->behavior_local_id,
+            .tap_ms = binding->tap_ms,
+            .param1 = binding->param1,
+            .param2 = binding->param2,
+            .hold_ms = binding->hold_ms,
+        };
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&event_log_lock);
+    record.sequence = event_log_sequence++;
+    event_log[record.sequence % EVENT_LOG_SIZE] = record;
+    k_spin_unlock(&event_log_lock, key);
+}
+
+int zmk_runtime_sensor_rotate_drain_events(uint32_t since,
+                                           struct runtime_sensor_rotate_event_record *out,
+                                           size_t max_count, uint32_t *next_sequence,
+                                           uint32_t *dropped) {
+    atomic_set(&event_log_until, (atomic_val_t)(uint32_t)(k_uptime_get() + EVENT_LOG_IDLE_MS));
+
+    k_spinlock_key_t key = k_spin_lock(&event_log_lock);
+    uint32_t end = event_log_sequence;
+    uint32_t oldest = end - MIN(end, EVENT_LOG_SIZE);
+    *dropped = 0;
+    if (since > end) {
+        // From before a reboot, start over with what is left
+        since = oldest;
+    } else if (since < oldest) {
+        *dropped = oldest - since;
+        since = oldest;
+    }
+
+    size_t count = MIN(end - since, max_count);
+    for (size_t i = 0; i < count; i++) {
+        out[i] = event_log[(since + i) % EVENT_LOG_SIZE];
+    }
+    k_spin_unlock(&event_log_lock, key);
+
+    *next_sequence = since + count;
+    return count;
+}
+
+#else
+
+static inline void event_log_keep_value(uint8_t sensor_index, uint8_t channel,
+                                        const struct zmk_behavior_binding_event *event,
+                                        const struct sensor_value *value) {}
+static inline void
+event_log_record(uint8_t sensor_index, uint8_t channel,
+                 const struct zmk_behavior_binding_event *event, int triggers, bool transparent,
+                 const struct runtime_sensor_rotate_resolved_binding *binding) {}
+
 #endif
-            triggered_binding_data.param1 = config->default_ccw_binding_params.param1;
-            triggered_binding_data.param2 = config->default_ccw_binding_params.param2;
-            triggered_binding_data.tap_ms = config->default_ccw_binding_params.tap_ms;
+
+static int behavior_runtime_sensor_rotate_accept_data(
+    struct zmk_behavior_binding *binding, struct zmk_behavior_binding_event event,
+    const struct zmk_sensor_config *sensor_config, size_t channel_data_size,
+    const struct zmk_sensor_channel_data *channel_data) {
+
+    int sensor_index = ZMK_SENSOR_POSITION_FROM_VIRTUAL_KEY_POSITION(event.position);
+
+    if (sensor_index >= ZMK_KEYMAP_SENSORS_LEN) {
+        LOG_ERR("Sensor index %d out of bounds", sensor_index);
+        return -EINVAL;
+    }
+
+    // Check if we already accepted data for this sensor/layer combination
+    for (uint8_t c = 0; c < ZMK_RUNTIME_SENSOR_ROTATE_MAX_CHANNELS; c++) {
+        const struct runtime_sensor_rotate_channel_state *state =
+            &global_data.channels[SENSOR_CHANNEL(sensor_index, c)];
+        if (state->accepted && state->layer == event.layer) {
+            LOG_DBG("Already accepted data for sensor %d layer %d", sensor_index, event.layer);
+            return 0;
         }
-    } else {
-#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_LOCAL_IDS_IN_BINDINGS)
-        // Resolve behavior name from local_id for runtime binding
-        behavior_name =
-            zmk_behavior_find_behavior_name_from_local_id(triggered_binding_data.behavior_local_id);
-#endif
-        if (!behavior_name) {
-            LOG_ERR("Failed to find behavior for local_id %d",
-                    triggered_binding_data.behavior_local_id);
-            return ZMK_BEHAVIOR_TRANSPARENT;
+    }
+    stats_event_accepted(sensor_index, event.layer);
+
+    // All layers see the same event, so only the first one updates the interval. Only runtime
+    // acceleration uses it.
+    if (sensor_index < ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS &&
+        event.timestamp != global_data.last_event_timestamp[sensor_index]) {
+        global_data.event_interval_ms[sensor_index] =
+            (uint32_t)MIN(event.timestamp - global_data.last_event_timestamp[sensor_index],
+                          UINT32_MAX);
+        global_data.last_event_timestamp[sensor_index] = event.timestamp;
+    }
+
+    int64_t scale = rsr_accumulator_scale(sensor_config->triggers_per_rotation,
+                                          get_resolution(sensor_index));
+
+    // Each channel of the event accumulates separately, channels beyond the configured count are
+    // ignored
+    for (uint8_t c = 0; c < ZMK_RUNTIME_SENSOR_ROTATE_MAX_CHANNELS; c++) {
+        int sc = SENSOR_CHANNEL(sensor_index, c);
+        struct runtime_sensor_rotate_channel_state *state = &global_data.channels[sc];
+
+        state->direction = 0;
+        if (c >= channel_data_size) {
+            state->layer = EFFECTIVE_LAYER_NONE;
+            state->accepted = false;
+            continue;
+        }
+
+        const struct sensor_value value = channel_data[c].value;
+        int direction = value.val1 != 0 ? value.val1 : value.val2;
+        state->direction = direction > 0 ? 1 : (direction < 0 ? -1 : 0);
+        event_log_keep_value(sensor_index, c, &event, &value);
+
+        // Only the layer playing the rotation accumulates it, the others fall through. Left alone
+        // when that layer already took this event.
+        int effective = direction != 0 ? get_effective_layer(sensor_index, c, direction)
+                                       : EFFECTIVE_LAYER_OTHER;
+        if (effective != EFFECTIVE_LAYER_OTHER && effective != event.layer) {
+            if (state->layer != effective) {
+                state->layer = effective;
+                state->accepted = false;
+            }
+            continue;
+        }
+
+        // Layers falling through to another behavior only count the triggers in the stats and
+        // the event log, they are the same for all of them and don't move the remainder
+        int64_t scratch = state->remainder;
+        int64_t *remainder = effective == EFFECTIVE_LAYER_OTHER ? &scratch : &state->remainder;
+        int triggers;
+
+        // Like behavior_sensor_rotate_common, val1 == 0 carries a trigger count in val2.
+        // Rotation is accumulated in fixed point, which is exact for counts that don't divide
+        // 360 too.
+        if (value.val1 == 0) {
+            triggers = value.val2;
+        } else {
+            triggers = rsr_accumulator_add(remainder, value.val1, value.val2, scale);
+        }
+
+        LOG_DBG("Sensor %d channel %d layer %d: val1=%d val2=%d triggers=%d", sensor_index, c,
+                event.layer, value.val1, value.val2, triggers);
+
+        if (effective == EFFECTIVE_LAYER_OTHER) {
+            state->layer = EFFECTIVE_LAYER_OTHER;
+            state->accepted = false;
+        } else {
+            triggers = apply_acceleration(sensor_index, c, event.layer, triggers);
+            state->layer = event.layer;
+            state->accepted = true;
         }
+        state->triggers = CLAMP(triggers, INT16_MIN, INT16_MAX);
     }
-    // Check if binding is configured
-    if (triggered_binding_data.behavior_local_id == 0 && behavior_name == NULL) {
-        LOG_DBG("No binding configured for sensor %d layer %d", sensor_index, event.layer);
+    return 0;
+}
+
+// Play back the triggers accepted for a sensor channel/layer with its binding
+static int trigger_binding(uint8_t sensor_index, uint8_t channel,
+                           struct zmk_behavior_binding_event event, int triggers) {
+    struct runtime_sensor_rotate_resolved_layer_bindings resolved;
+    const struct runtime_sensor_rotate_resolved_binding *triggered_binding_data;
+    if (!get_resolved_layer_bindings(sensor_index, channel, event.layer, &resolved)) {
         return ZMK_BEHAVIOR_TRANSPARENT;
+    } else if (!resolved.valid) {
+        stats_lookup_failed(sensor_index, event.layer);
     }
 
-    // Create the zmk_behavior_binding for execution
-    struct zmk_behavior_binding triggered_binding = {
-#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_LOCAL_IDS_IN_BINDINGS)
-        .local_id = triggered_binding_data.behavior_local_id,
-#endif
-        .behavior_dev = behavior_name,
-        .param1 = triggered_binding_data.param1,
-        .param2 = triggered_binding_data.param2,
-    };
+    if (triggers > 0) {
+        triggered_binding_data = &resolved.cw_binding;
+    } else if (triggers < 0) {
+        triggered_binding_data = &resolved.ccw_binding;
+    } else {
+        return ZMK_BEHAVIOR_TRANSPARENT;
+    }
 
-    // TODO: optimize transparent behavior check
-    if (strcmp(triggered_binding.behavior_dev, "transparent") == 0) {
-        LOG_DBG("Binding is transparent behavior, skipping");
+    if (triggered_binding_data->transparent) {
+        LOG_DBG("No binding or transparent binding for sensor %d channel %d layer %d",
+                sensor_index, channel, event.layer);
+        stats_transparent(sensor_index, event.layer);
+        event_log_record(sensor_index, channel, &event, triggers, true, NULL);
         return ZMK_BEHAVIOR_TRANSPARENT;
     }
 
+    stats_triggered(sensor_index, event.layer, triggers);
+    event_log_record(sensor_index, channel, &event, triggers, false, triggered_binding_data);
+
 #if IS_ENABLED(CONFIG_ZMK_SPLIT)
     event.source = ZMK_POSITION_STATE_CHANGE_SOURCE_LOCAL;
 #endif
 
+    if (triggered_binding_data->hold_ms > 0) {
+        hold_triggers(sensor_index, channel, triggered_binding_data, &event, triggers);
+        return ZMK_BEHAVIOR_OPAQUE;
+    }
+    hold_release(sensor_index, channel);
+
+    if (resolved.config && resolved.config->coalesce) {
+        coalesce_triggers(sensor_index, channel, resolved.config->coalesce_max_pending,
+                          triggered_binding_data, &event, triggers);
+        return ZMK_BEHAVIOR_OPAQUE;
+    }
+
+    // Create the zmk_behavior_binding for execution
+    struct zmk_behavior_binding triggered_binding = to_behavior_binding(triggered_binding_data);
+
     if (triggers < 0) {
         triggers = -triggers;
     }
 
+    uint16_t tap_ms = bound_tap_ms(sensor_index, triggered_binding_data->tap_ms, triggers);
+    if (tap_ms != triggered_binding_data->tap_ms) {
+        LOG_DBG("Sensor %d layer %d: tap-ms %d shortened to %d for %d taps", sensor_index,
+                event.layer, triggered_binding_data->tap_ms, tap_ms, triggers);
+    }
+    stats_tap_ms(sensor_index, event.layer, tap_ms, tap_ms != triggered_binding_data->tap_ms);
+
     for (int i = 0; i < triggers; i++) {
-        zmk_behavior_queue_add(&event, triggered_binding, true, triggered_binding_data.tap_ms);
+        zmk_behavior_queue_add(&event, triggered_binding, true, tap_ms);
         zmk_behavior_queue_add(&event, triggered_binding, false, 0);
     }
 
     return ZMK_BEHAVIOR_OPAQUE;
 }
 
+static int behavior_runtime_sensor_rotate_process(struct zmk_behavior_binding *binding,
+                                                  struct zmk_behavior_binding_event event,
+                                                  enum behavior_sensor_binding_process_mode mode) {
+
+    const int sensor_index = ZMK_SENSOR_POSITION_FROM_VIRTUAL_KEY_POSITION(event.position);
+
+    if (sensor_index >= ZMK_KEYMAP_SENSORS_LEN) {
+        LOG_ERR("Sensor index %d out of bounds", sensor_index);
+        return -EINVAL;
+    }
+
+    if (mode != BEHAVIOR_SENSOR_BINDING_PROCESS_MODE_TRIGGER) {
+        // Drop the triggers taken for this layer
+        for (uint8_t c = 0; c < ZMK_RUNTIME_SENSOR_ROTATE_MAX_CHANNELS; c++) {
+            struct runtime_sensor_rotate_channel_state *state =
+                &global_data.channels[SENSOR_CHANNEL(sensor_index, c)];
+            if (state->layer == event.layer) {
+                state->accepted = false;
+            }
+        }
+        return ZMK_BEHAVIOR_TRANSPARENT;
+    }
+
+    // All channels are played back in this pass. The keymap falls through per sensor, so
+    // transparent channels are dropped when another channel of the layer handled the event.
+    uint32_t start = stats_process_start();
+    int ret = ZMK_BEHAVIOR_TRANSPARENT;
+    for (uint8_t c = 0; c < ZMK_RUNTIME_SENSOR_ROTATE_MAX_CHANNELS; c++) {
+        struct runtime_sensor_rotate_channel_state *state =
+            &global_data.channels[SENSOR_CHANNEL(sensor_index, c)];
+        int triggers = 0;
+        if (state->layer == EFFECTIVE_LAYER_OTHER) {
+            triggers = state->triggers;
+        } else if (state->layer == event.layer && state->accepted) {
+            triggers = state->triggers;
+            state->accepted = false;
+        }
+        int8_t direction = state->direction;
+        if (triggers == 0) {
+            // Nothing to play, no need to resolve the bindings. Layers above the effective one
+            // fall through to it, the ones below it have nothing left to fall through.
+            if (direction != 0) {
+                int effective = get_effective_layer(sensor_index, c, direction);
+                if (effective == event.layer) {
+                    state->direction = 0;
+                    event_log_record(sensor_index, c, &event, 0, false, NULL);
+                } else if (effective != EFFECTIVE_LAYER_OTHER) {
+                    stats_transparent(sensor_index, event.layer);
+                    event_log_record(sensor_index, c, &event, 0, true, NULL);
+                }
+            }
+            continue;
+        }
+        if (trigger_binding(sensor_index, c, event, triggers) == ZMK_BEHAVIOR_OPAQUE) {
+            ret = ZMK_BEHAVIOR_OPAQUE;
+        }
+    }
+    stats_process_done(sensor_index, event.layer, start);
+    return ret;
+}
+
+// Activating or deactivating a layer moves the effective layers, see get_effective_layer
+static int layer_state_changed_listener(const zmk_event_t *eh) {
+    invalidate_effective_layers();
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(behavior_runtime_sensor_rotate, layer_state_changed_listener);
+ZMK_SUBSCRIPTION(behavior_runtime_sensor_rotate, zmk_layer_state_changed);
+
+static int behavior_runtime_sensor_rotate_init(const struct device *dev) {
+    static bool init_first_run = true;
+
+    if (init_first_run) {
+        for (int i = 0; i < RUNTIME_SENSOR_ROTATE_SENSOR_CHANNELS; i++) {
+            k_work_init_delayable(&global_data.coalesce[i].work, coalesce_work_handler);
+            k_work_init_delayable(&global_data.hold[i].work, hold_work_handler);
+        }
+        init_first_run = false;
+    }
+    return 0;
+}
+
 static const struct behavior_driver_api behavior_runtime_sensor_rotate_driver_api = {
     .sensor_binding_accept_data = behavior_runtime_sensor_rotate_accept_data,
     .sensor_binding_process = behavior_runtime_sensor_rotate_process};
@@ -387,6 +2931,7 @@ static const struct behavior_driver_api behavior_runtime_sensor_rotate_driver_ap
 #define RUNTIME_SENSOR_ROTATE_INST(n)                                                              \
     static struct behavior_runtime_sensor_rotate_config                                            \
         behavior_runtime_sensor_rotate_config_##n = {                                              \
+            .index = n,                                                                            \
             .default_cw_binding_name =                                                             \
                 COND_CODE_1(DT_INST_NODE_HAS_PROP(n, cw_binding),                                  \
                             (DEVICE_DT_NAME(DT_INST_PHANDLE_BY_IDX(n, cw_binding, 0))), (NULL)),   \
@@ -401,7 +2946,8 @@ static const struct behavior_driver_api behavior_runtime_sensor_rotate_driver_ap
                   .param2 =                                                                        \
                       COND_CODE_1(DT_PHA_HAS_CELL_AT_IDX(DT_DRV_INST(n), cw_binding, 0, param2),   \
                                   (DT_PHA_BY_IDX(DT_DRV_INST(n), cw_binding, 0, param2)), (0)),    \
-                  .tap_ms = DT_INST_PROP_OR(n, tap_ms, 5)}),                                       \
+                  .tap_ms = DT_INST_PROP_OR(n, tap_ms, 5),                                         \
+                  .hold_ms = DT_INST_PROP(n, hold_ms)}),                                           \
                 ({})),                                                                             \
             .default_ccw_binding_params = COND_CODE_1(                                             \
                 DT_INST_NODE_HAS_PROP(n, ccw_binding),                                             \
@@ -411,12 +2957,16 @@ static const struct behavior_driver_api behavior_runtime_sensor_rotate_driver_ap
                   .param2 =                                                                        \
                       COND_CODE_1(DT_PHA_HAS_CELL_AT_IDX(DT_DRV_INST(n), ccw_binding, 0, param2),  \
                                   (DT_PHA_BY_IDX(DT_DRV_INST(n), ccw_binding, 0, param2)), (0)),   \
-                  .tap_ms = DT_INST_PROP_OR(n, tap_ms, 5)}),                                       \
+                  .tap_ms = DT_INST_PROP_OR(n, tap_ms, 5),                                         \
+                  .hold_ms = DT_INST_PROP(n, hold_ms)}),                                           \
                 ({})),                                                                             \
+            .coalesce = DT_INST_PROP(n, coalesce),                                                 \
+            .coalesce_max_pending = DT_INST_PROP(n, coalesce_max_pending),                         \
     };                                                                                             \
                                                                                                    \
     BEHAVIOR_DT_INST_DEFINE(                                                                       \
-        n, NULL, NULL, &global_data, &behavior_runtime_sensor_rotate_config_##n, POST_KERNEL,      \
+        n, behavior_runtime_sensor_rotate_init, NULL, &global_data,                                \
+        &behavior_runtime_sensor_rotate_config_##n, POST_KERNEL,                                   \
         CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &behavior_runtime_sensor_rotate_driver_api);
 
 DT_INST_FOREACH_STATUS_OKAY(RUNTIME_SENSOR_ROTATE_INST)
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Switches the active binding profile of the runtime sensor rotate behavior on press, like
+// &rsr_profile 1.
+
+#define DT_DRV_COMPAT zmk_behavior_runtime_sensor_rotate_profile
+
+#include <zephyr/device.h>
+#include <zephyr/logging/log.h>
+
+#include <drivers/behavior.h>
+#include <zmk/behavior.h>
+#include <zmk/behaviors/runtime_sensor_rotate.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
+
+static const struct behavior_parameter_value_metadata profile_param_values[] = {
+    {
+        .display_name = "Profile",
+        .type = BEHAVIOR_PARAMETER_VALUE_TYPE_RANGE,
+        .range = {.min = 0, .max = ZMK_RUNTIME_SENSOR_ROTATE_PROFILES - 1},
+    },
+};
+
+static const struct behavior_parameter_metadata_set profile_metadata_set = {
+    .param1_values = profile_param_values,
+    .param1_values_len = ARRAY_SIZE(profile_param_values),
+};
+
+static const struct behavior_parameter_metadata profile_metadata = {
+    .sets_len = 1,
+    .sets = &profile_metadata_set,
+};
+
+#endif
+
+static int profile_pressed(struct zmk_behavior_binding *binding,
+                           struct zmk_behavior_binding_event event) {
+    int rc = zmk_runtime_sensor_rotate_set_active_profile(binding->param1);
+    if (rc != 0) {
+        LOG_ERR("Failed to switch to profile %d: %d", binding->param1, rc);
+    }
+    return ZMK_BEHAVIOR_OPAQUE;
+}
+
+static int profile_released(struct zmk_behavior_binding *binding,
+                            struct zmk_behavior_binding_event event) {
+    return ZMK_BEHAVIOR_OPAQUE;
+}
+
+static const struct behavior_driver_api profile_driver_api = {
+    .binding_pressed = profile_pressed,
+    .binding_released = profile_released,
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
+    .parameter_metadata = &profile_metadata,
+#endif
+};
+
+#define RUNTIME_SENSOR_ROTATE_PROFILE_INST(n)                                                      \
+    BEHAVIOR_DT_INST_DEFINE(n, NULL, NULL, NULL, NULL, POST_KERNEL,                                \
+                            CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &profile_driver_api);
+
+DT_INST_FOREACH_STATUS_OKAY(RUNTIME_SENSOR_ROTATE_PROFILE_INST)
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// Fixed-point rotation accumulator of the runtime sensor rotate behavior. Free of Zephyr
+// dependencies so that tests/host can check it against the sensor_value math it replaced.
+//
+// Rotation is accumulated in units of 1 / RSR_ACCUMULATOR_UNITS_PER_TRIGGER of a trigger. An event
+// of d micro-degrees adds d * triggers_per_rotation * resolution_percent units, so that a whole
+// rotation at 100% adds exactly triggers_per_rotation triggers. Counts that don't divide 360 and
+// resolutions other than 100% are represented exactly as well.
+
+#include <stdint.h>
+
+#define RSR_ACCUMULATOR_MICRO_DEGREES 1000000
+#define RSR_ACCUMULATOR_UNITS_PER_TRIGGER (360LL * RSR_ACCUMULATOR_MICRO_DEGREES * 100)
+
+// floor(2^48 / RSR_ACCUMULATOR_UNITS_PER_TRIGGER). Applied to the magnitude shifted right by 16
+// and the product shifted right by 32, it never overestimates the quotient and can't overflow.
+#define RSR_ACCUMULATOR_RECIPROCAL 7818
+
+// Units added per micro-degree of rotation, computed once per event instead of dividing 360 by
+// triggers_per_rotation
+static inline int64_t rsr_accumulator_scale(int triggers_per_rotation, int resolution_percent) {
+    return (int64_t)triggers_per_rotation * resolution_percent;
+}
+
+// Add the rotation of an event given as degrees and micro-degrees like a sensor_value, and take
+// the whole triggers out of the accumulator. The remainder keeps the sign of the rotation, so
+// that the result truncates towards zero like integer division.
+static inline int rsr_accumulator_add(int64_t *acc, int32_t degrees, int32_t micro_degrees,
+                                      int64_t scale) {
+    *acc += ((int64_t)degrees * RSR_ACCUMULATOR_MICRO_DEGREES + micro_degrees) * scale;
+
+    uint64_t magnitude = *acc < 0 ? -(uint64_t)*acc : (uint64_t)*acc;
+    uint64_t triggers = ((magnitude >> 16) * RSR_ACCUMULATOR_RECIPROCAL) >> 32;
+    uint64_t remainder = magnitude - triggers * RSR_ACCUMULATOR_UNITS_PER_TRIGGER;
+    // The estimate is short by at most a trigger or two for any realistic event
+    while (remainder >= RSR_ACCUMULATOR_UNITS_PER_TRIGGER) {
+        remainder -= RSR_ACCUMULATOR_UNITS_PER_TRIGGER;
+        triggers++;
+    }
+
+    if (*acc < 0) {
+        *acc = -(int64_t)remainder;
+        return -(int)triggers;
+    }
+    *acc = (int64_t)remainder;
+    return (int)triggers;
+}
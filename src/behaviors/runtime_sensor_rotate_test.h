@@ -0,0 +1,15 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// Test seams of the runtime sensor rotate behavior. The behavior defines each as a weak no-op,
+// and only the test images under tests/ override them.
+
+// Called between the words of every copy that publishes a runtime binding to the sensor event
+// path. tests/stress yields there, since native_posix never switches threads in the middle of a
+// copy by itself.
+void rsr_test_preempt(void);
@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Feeds synthetic sensor events through the sensor binding API of the runtime sensor rotate
+// behavior the same way zmk_keymap_sensor_event does, and prints per-event cost as one JSON
+// object per scenario. Only meant for native_posix, see tests/bench.
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include <dt-bindings/zmk/keys.h>
+
+#include <drivers/behavior.h>
+#include <zmk/behavior.h>
+#include <zmk/keymap.h>
+#include <zmk/sensors.h>
+#include <zmk/virtual_key_position.h>
+#include <zmk/behaviors/runtime_sensor_rotate.h>
+
+#include <string.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#define BENCH_EVENTS CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_BENCHMARK_EVENTS
+#define BENCH_LAYERS 4
+// Layers random layer sets are picked from. The hold layer would shadow all others.
+#define BENCH_RANDOM_LAYERS 3
+#define BENCH_SENSORS 2
+#define BENCH_TRIGGERS_PER_ROTATION 20
+
+BUILD_ASSERT(ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS >= BENCH_LAYERS,
+             "The benchmark needs runtime configuration on at least 4 layers");
+BUILD_ASSERT(ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS >= BENCH_SENSORS,
+             "The benchmark needs runtime configuration on at least 2 sensors");
+
+enum bench_direction {
+    BENCH_DIRECTION_CW,
+    BENCH_DIRECTION_ALTERNATING,
+    BENCH_DIRECTION_RANDOM,
+};
+
+struct bench_scenario {
+    const char *name;
+    // Sensor receiving the events, -1 for a random one per event
+    int8_t sensor_index;
+    // Active layers, 0 for a random set on top of the default layer per event
+    uint8_t layer_mask;
+    enum bench_direction direction;
+    // Time between events, short intervals exercise acceleration
+    uint8_t interval_ms;
+};
+
+// Bindings of tests/bench/native_posix_64.keymap:
+//   layer 0: &rsr_kp    &rsr_kp
+//   layer 1: &rsr_trans &rsr_coalesce
+//   layer 2: &rsr_trans &rsr_trans, sensor 0 overridden at runtime with acceleration
+//   layer 3: &rsr_hold  &rsr_hold
+static const struct bench_scenario scenarios[] = {
+    {"default_cw", 0, BIT(0), BENCH_DIRECTION_CW, 50},
+    {"default_alternating", 0, BIT(0), BENCH_DIRECTION_ALTERNATING, 50},
+    {"transparent_fallthrough", 0, BIT(0) | BIT(1), BENCH_DIRECTION_CW, 50},
+    {"runtime_accelerated", 0, BIT(0) | BIT(1) | BIT(2), BENCH_DIRECTION_CW, 5},
+    {"coalesce", 1, BIT(0) | BIT(1), BENCH_DIRECTION_RANDOM, 5},
+    {"mixed", -1, 0, BENCH_DIRECTION_RANDOM, 10},
+    {"hold", 0, BIT(0) | BIT(3), BENCH_DIRECTION_CW, 5},
+};
+
+// Per-event cost of the running scenario as a log-linear histogram, so that its size doesn't
+// depend on the number of events. Values below BENCH_LINEAR_LIMIT get a bucket each, every octave
+// above is split into BENCH_SUB_BUCKETS, which bounds the error of a percentile to about 3%.
+#define BENCH_SUB_BITS 5
+#define BENCH_SUB_BUCKETS BIT(BENCH_SUB_BITS)
+#define BENCH_LINEAR_LIMIT (2 * BENCH_SUB_BUCKETS)
+#define BENCH_BUCKETS (BENCH_LINEAR_LIMIT + (32 - BENCH_SUB_BITS - 1) * BENCH_SUB_BUCKETS)
+
+static uint32_t histogram[BENCH_BUCKETS];
+
+static struct zmk_behavior_binding sensor_bindings[BENCH_LAYERS][BENCH_SENSORS] = {
+    {{.behavior_dev = "rsr_kp"}, {.behavior_dev = "rsr_kp"}},
+    {{.behavior_dev = "rsr_trans"}, {.behavior_dev = "rsr_coalesce"}},
+    {{.behavior_dev = "rsr_trans"}, {.behavior_dev = "rsr_trans"}},
+    {{.behavior_dev = "rsr_hold"}, {.behavior_dev = "rsr_hold"}},
+};
+
+static const struct zmk_sensor_config sensor_config = {
+    .triggers_per_rotation = BENCH_TRIGGERS_PER_ROTATION,
+};
+
+// Deterministic, so that runs are comparable
+static uint32_t bench_random_state = 1;
+
+static uint32_t bench_random(void) {
+    bench_random_state = bench_random_state * 1664525 + 1013904223;
+    return bench_random_state >> 8;
+}
+
+static inline uint64_t bench_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    // Host TSC; the simulated kernel clock doesn't advance while the benchmark runs
+    return __builtin_ia32_rdtsc();
+#else
+    return k_cycle_get_64();
+#endif
+}
+
+static uint32_t bucket_of(uint32_t cycles) {
+    if (cycles < BENCH_LINEAR_LIMIT) {
+        return cycles;
+    }
+    int shift = 31 - __builtin_clz(cycles) - BENCH_SUB_BITS;
+    return BENCH_LINEAR_LIMIT + (shift - 1) * BENCH_SUB_BUCKETS +
+           ((cycles >> shift) - BENCH_SUB_BUCKETS);
+}
+
+// Largest value that falls into a bucket, so that percentiles never understate the cost
+static uint32_t bucket_limit(uint32_t bucket) {
+    if (bucket < BENCH_LINEAR_LIMIT) {
+        return bucket;
+    }
+    int shift = (bucket - BENCH_LINEAR_LIMIT) / BENCH_SUB_BUCKETS + 1;
+    uint64_t base = (uint64_t)((bucket - BENCH_LINEAR_LIMIT) % BENCH_SUB_BUCKETS +
+                               BENCH_SUB_BUCKETS)
+                    << shift;
+    return (uint32_t)MIN(base + BIT(shift) - 1, UINT32_MAX);
+}
+
+static uint32_t percentile(uint32_t permille) {
+    uint64_t rank = (uint64_t)(BENCH_EVENTS - 1) * permille / 1000;
+    uint64_t seen = 0;
+    for (uint32_t bucket = 0; bucket < BENCH_BUCKETS; bucket++) {
+        seen += histogram[bucket];
+        if (seen > rank) {
+            return bucket_limit(bucket);
+        }
+    }
+    return UINT32_MAX;
+}
+
+// Same sequence of calls as zmk_keymap_sensor_event for one event
+static void bench_sensor_event(uint8_t sensor_index, uint8_t layer_mask, int direction,
+                               int64_t timestamp) {
+    struct zmk_sensor_channel_data channel_data = {
+        .channel = SENSOR_CHAN_ROTATION,
+        .value = {.val1 = direction * (360 / BENCH_TRIGGERS_PER_ROTATION)},
+    };
+    bool opaque_response = false;
+
+    for (int layer = BENCH_LAYERS - 1; layer >= 0; layer--) {
+        struct zmk_behavior_binding *binding = &sensor_bindings[layer][sensor_index];
+        struct zmk_behavior_binding_event event = {
+            .layer = layer,
+            .position = ZMK_VIRTUAL_KEY_POSITION_SENSOR(sensor_index),
+            .timestamp = timestamp,
+        };
+
+        behavior_sensor_keymap_binding_accept_data(binding, event, &sensor_config, 1,
+                                                   &channel_data);
+
+        enum behavior_sensor_binding_process_mode mode =
+            (!opaque_response && (layer_mask & BIT(layer)))
+                ? BEHAVIOR_SENSOR_BINDING_PROCESS_MODE_TRIGGER
+                : BEHAVIOR_SENSOR_BINDING_PROCESS_MODE_DISCARD;
+        if (behavior_sensor_keymap_binding_process(binding, event, mode) ==
+            ZMK_BEHAVIOR_OPAQUE) {
+            opaque_response = true;
+        }
+    }
+}
+
+// Make the keymap layer state match the layers the events are fed to, which the behavior reads to
+// find the effective layer. The default layer 0 stays active.
+static void bench_set_layers(uint8_t layer_mask) {
+    for (uint8_t layer = 1; layer < BENCH_LAYERS; layer++) {
+        if (layer_mask & BIT(layer)) {
+            zmk_keymap_layer_activate(layer);
+        } else {
+            zmk_keymap_layer_deactivate(layer);
+        }
+    }
+}
+
+static void run_scenario(const struct bench_scenario *scenario) {
+    uint64_t total_cycles = 0;
+    uint32_t max_cycles = 0;
+    int64_t timestamp = 0;
+    uint8_t active_layers = 0;
+
+    memset(histogram, 0, sizeof(histogram));
+    for (uint32_t i = 0; i < BENCH_EVENTS; i++) {
+        uint8_t sensor_index = scenario->sensor_index >= 0 ? (uint8_t)scenario->sensor_index
+                                                           : bench_random() % BENCH_SENSORS;
+        uint8_t layer_mask = scenario->layer_mask
+                                 ? scenario->layer_mask
+                                 : BIT(0) | bench_random() % BIT(BENCH_RANDOM_LAYERS);
+        if (layer_mask != active_layers) {
+            bench_set_layers(layer_mask);
+            active_layers = layer_mask;
+        }
+        int direction;
+        switch (scenario->direction) {
+        case BENCH_DIRECTION_ALTERNATING:
+            direction = (i & 1) ? -1 : 1;
+            break;
+        case BENCH_DIRECTION_RANDOM:
+            direction = (bench_random() & 1) ? -1 : 1;
+            break;
+        default:
+            direction = 1;
+            break;
+        }
+        timestamp += scenario->interval_ms;
+
+        // Keep the behavior queue and coalesce work items from running during the event. They
+        // play back what it queued once the scheduler is unlocked, outside of the measurement.
+        k_sched_lock();
+        uint64_t start = bench_cycles();
+        bench_sensor_event(sensor_index, layer_mask, direction, timestamp);
+        uint64_t cycles = bench_cycles() - start;
+        k_sched_unlock();
+
+        uint32_t sample = (uint32_t)MIN(cycles, UINT32_MAX);
+        histogram[bucket_of(sample)]++;
+        max_cycles = MAX(max_cycles, sample);
+        total_cycles += cycles;
+    }
+    bench_set_layers(BIT(0));
+
+    printk("rsr_bench: {\"scenario\":\"%s\",\"events\":%u,\"cycles_mean\":%llu,"
+           "\"cycles_p50\":%u,\"cycles_p90\":%u,\"cycles_p99\":%u,\"cycles_p999\":%u,"
+           "\"cycles_max\":%u}\n",
+           scenario->name, BENCH_EVENTS, (unsigned long long)(total_cycles / BENCH_EVENTS),
+           percentile(500), percentile(900), percentile(990), percentile(999), max_cycles);
+}
+
+static int bench_setup(void) {
+    zmk_behavior_local_id_t kp = zmk_behavior_get_local_id("key_press");
+    if (kp == UINT16_MAX) {
+        return -ENODEV;
+    }
+
+    // Sensor 0 layer 2 gets runtime bindings, everything else uses the devicetree defaults
+    const struct runtime_sensor_rotate_update updates[] = {
+        {
+            .sensor_index = 0,
+            .layer = 2,
+            .type = RUNTIME_SENSOR_ROTATE_UPDATE_CW_BINDING,
+            .binding = {.behavior_local_id = kp, .param1 = C_VOL_UP},
+        },
+        {
+            .sensor_index = 0,
+            .layer = 2,
+            .type = RUNTIME_SENSOR_ROTATE_UPDATE_CCW_BINDING,
+            .binding = {.behavior_local_id = kp, .param1 = C_VOL_DN},
+        },
+        {
+            .sensor_index = 0,
+            .layer = 2,
+            .type = RUNTIME_SENSOR_ROTATE_UPDATE_ACCELERATION,
+            .acceleration = {.threshold_ms = 50, .multiplier = 300, .max_triggers = 4},
+        },
+    };
+    return zmk_runtime_sensor_rotate_apply_updates(updates, ARRAY_SIZE(updates));
+}
+
+static void bench_thread(void *p1, void *p2, void *p3) {
+    int rc = bench_setup();
+    if (rc != 0) {
+        printk("rsr_bench_error: setup failed %d\n", rc);
+        return;
+    }
+
+    for (size_t i = 0; i < ARRAY_SIZE(scenarios); i++) {
+        run_scenario(&scenarios[i]);
+    }
+    printk("rsr_bench_done: scenarios=%d events=%d\n", (int)ARRAY_SIZE(scenarios), BENCH_EVENTS);
+}
+
+K_THREAD_DEFINE(rsr_bench, 4096, bench_thread, NULL, NULL, NULL, K_LOWEST_APPLICATION_THREAD_PRIO,
+                0, 0);
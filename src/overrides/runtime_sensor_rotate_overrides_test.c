@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Sets one direction of a layer bound in the devicetree, like the SetLayerCwBinding RPC does,
+// resets it and checks that its override slot is free again for another layer. The build has a
+// single slot, so a leaked one fails the second layer. Only meant for native_posix, see
+// tests/overrides.
+
+#include <zephyr/kernel.h>
+
+#include <dt-bindings/zmk/keys.h>
+#include <zmk/behavior.h>
+#include <zmk/behaviors/runtime_sensor_rotate.h>
+
+BUILD_ASSERT(CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_MAX_OVERRIDES == 1,
+             "tests/overrides relies on a single override slot");
+
+static int set_cw_binding(uint8_t layer, const struct runtime_sensor_rotate_binding *binding) {
+    struct runtime_sensor_rotate_update update = {
+        .sensor_index = 0,
+        .layer = layer,
+        .type = RUNTIME_SENSOR_ROTATE_UPDATE_CW_BINDING,
+        .binding = *binding,
+    };
+    return zmk_runtime_sensor_rotate_apply_updates(&update, 1);
+}
+
+static void overrides_test(void *p1, void *p2, void *p3) {
+    const struct runtime_sensor_rotate_binding binding = {
+        .behavior_local_id = zmk_behavior_get_local_id("key_press"),
+        .param1 = C,
+    };
+    const struct runtime_sensor_rotate_binding none = {};
+    struct runtime_sensor_rotate_layer_bindings runtime;
+
+    int set_rc = set_cw_binding(0, &binding);
+    // The devicetree CCW binding stays a default rather than being copied into the override
+    int get_rc = zmk_runtime_sensor_rotate_get_layer_bindings(0, 0, &runtime);
+    int reset_rc = set_cw_binding(0, &none);
+    int other_rc = set_cw_binding(1, &binding);
+    set_cw_binding(1, &none);
+
+    printk("rsr_overrides_done: set=%d get=%d ccw=%d reset=%d other_layer=%d\n", set_rc, get_rc,
+           runtime.ccw_binding.behavior_local_id, reset_rc, other_rc);
+}
+
+K_THREAD_DEFINE(rsr_overrides, 2048, overrides_test, NULL, NULL, NULL,
+                K_LOWEST_APPLICATION_THREAD_PRIO, 0, 0);
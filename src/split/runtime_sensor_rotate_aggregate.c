@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Aggregates the sensor events of a split peripheral before they are sent to the central. Each
+// raw event is captured and its rotation added up per sensor channel, and the net rotation of
+// each sensor is raised once per interval for the split service to send. The central
+// accumulates it like the raw events, so the remainders per layer, the resolution and the
+// runtime bindings stay where the configuration lives, while a fast spin crosses the split link
+// once per interval instead of once per detent.
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include <zmk/event_manager.h>
+#include <zmk/events/sensor_event.h>
+#include <zmk/sensors.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#define AGGREGATE_INTERVAL_MS CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_SPLIT_AGGREGATE_INTERVAL_MS
+#define MICRO_DEGREES 1000000
+
+struct aggregate_state {
+    // Net rotation since the last flush per channel, in micro-degrees
+    int64_t rotation[ZMK_SENSOR_EVENT_MAX_CHANNELS];
+    // Channels and timestamp of the last raw event
+    enum sensor_channel channels[ZMK_SENSOR_EVENT_MAX_CHANNELS];
+    size_t channel_data_size;
+    int64_t timestamp;
+    bool pending;
+};
+
+// Sensor drivers may raise their events from their own thread rather than the system work queue
+// the flush runs on
+static struct k_spinlock aggregate_lock;
+static struct aggregate_state aggregate_states[ZMK_KEYMAP_SENSORS_LEN];
+
+static void flush_sensor(uint8_t sensor_index);
+
+static void aggregate_flush_handler(struct k_work *work) {
+    for (uint8_t s = 0; s < ZMK_KEYMAP_SENSORS_LEN; s++) {
+        flush_sensor(s);
+    }
+}
+
+static K_WORK_DELAYABLE_DEFINE(aggregate_flush_work, aggregate_flush_handler);
+
+// Add the rotation of a raw event to the pending one. Returns false if it has to be flushed
+// first because the channel layout changed.
+static bool aggregate_event(const struct zmk_sensor_event *ev) {
+    struct aggregate_state *state = &aggregate_states[ev->sensor_index];
+    size_t channel_data_size = MIN(ev->channel_data_size, ZMK_SENSOR_EVENT_MAX_CHANNELS);
+    bool schedule = false;
+
+    k_spinlock_key_t key = k_spin_lock(&aggregate_lock);
+    if (state->pending && channel_data_size != state->channel_data_size) {
+        k_spin_unlock(&aggregate_lock, key);
+        return false;
+    }
+    for (size_t c = 0; c < channel_data_size; c++) {
+        const struct sensor_value *value = &ev->channel_data[c].value;
+        state->rotation[c] += (int64_t)value->val1 * MICRO_DEGREES + value->val2;
+        state->channels[c] = ev->channel_data[c].channel;
+    }
+    state->channel_data_size = channel_data_size;
+    state->timestamp = ev->timestamp;
+    if (!state->pending) {
+        state->pending = true;
+        schedule = true;
+    }
+    k_spin_unlock(&aggregate_lock, key);
+
+    if (schedule) {
+        // Counted from the first event of the interval, so that the delay stays bounded while
+        // events keep coming in
+        k_work_schedule(&aggregate_flush_work, K_MSEC(AGGREGATE_INTERVAL_MS));
+    }
+    return true;
+}
+
+// Like behavior_sensor_rotate_common, val1 == 0 carries a trigger count in val2 rather than an
+// angle
+static bool is_trigger_count(const struct zmk_sensor_event *ev) {
+    for (size_t c = 0; c < MIN(ev->channel_data_size, ZMK_SENSOR_EVENT_MAX_CHANNELS); c++) {
+        if (ev->channel_data[c].value.val1 == 0 && ev->channel_data[c].value.val2 != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static int aggregate_listener(const zmk_event_t *eh) {
+    const struct zmk_sensor_event *ev = as_zmk_sensor_event(eh);
+    if (ev == NULL || ev->sensor_index >= ZMK_KEYMAP_SENSORS_LEN) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    if (is_trigger_count(ev)) {
+        // Sent as is, after the rotation before it
+        flush_sensor(ev->sensor_index);
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    if (!aggregate_event(ev)) {
+        flush_sensor(ev->sensor_index);
+        aggregate_event(ev);
+    }
+    return ZMK_EV_EVENT_CAPTURED;
+}
+
+// Sorted before the listeners of the split service and the keymap, which only see the
+// aggregated events
+ZMK_LISTENER(behavior_runtime_sensor_rotate_aggregate, aggregate_listener);
+ZMK_SUBSCRIPTION(behavior_runtime_sensor_rotate_aggregate, zmk_sensor_event);
+
+// Raise the net rotation of a sensor since the last flush, if any
+static void flush_sensor(uint8_t sensor_index) {
+    struct aggregate_state *state = &aggregate_states[sensor_index];
+    struct zmk_sensor_event data = {.sensor_index = sensor_index};
+    bool moved = false;
+
+    k_spinlock_key_t key = k_spin_lock(&aggregate_lock);
+    if (!state->pending) {
+        k_spin_unlock(&aggregate_lock, key);
+        return;
+    }
+    data.channel_data_size = state->channel_data_size;
+    data.timestamp = state->timestamp;
+    for (size_t c = 0; c < state->channel_data_size; c++) {
+        // Truncated towards zero on both parts, which keeps val1 and val2 the same sign like
+        // sensor drivers report them
+        int32_t degrees = (int32_t)(state->rotation[c] / MICRO_DEGREES);
+        data.channel_data[c].channel = state->channels[c];
+        if (degrees == 0) {
+            // Less than a degree would read as a trigger count, carried over to the next flush
+            continue;
+        }
+        data.channel_data[c].value.val1 = degrees;
+        data.channel_data[c].value.val2 = (int32_t)(state->rotation[c] % MICRO_DEGREES);
+        state->rotation[c] = 0;
+        moved = true;
+    }
+    state->pending = false;
+    k_spin_unlock(&aggregate_lock, key);
+
+    // Back and forth within an interval cancels out, nothing to send
+    if (!moved) {
+        return;
+    }
+
+    LOG_DBG("Sensor %d: sending aggregated rotation %d.%06d", sensor_index,
+            data.channel_data[0].value.val1, data.channel_data[0].value.val2);
+    struct zmk_sensor_event_event event = copy_raised_zmk_sensor_event(&data);
+    ZMK_EVENT_RAISE_AFTER(event, behavior_runtime_sensor_rotate_aggregate);
+}
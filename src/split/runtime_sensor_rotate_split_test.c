@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Raises bursts of raw sensor events on a single image with the peripheral aggregation enabled,
+// so that the keymap sees the aggregated events as the central would. Counts the taps of the
+// bound keys and compares them with the trigger counts of the raw events run through the
+// accumulator one at a time, like without aggregation. Only meant for native_posix, see
+// tests/split.
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include <dt-bindings/zmk/hid_usage.h>
+#include <dt-bindings/zmk/hid_usage_pages.h>
+
+#include <zmk/event_manager.h>
+#include <zmk/events/keycode_state_changed.h>
+#include <zmk/events/sensor_event.h>
+#include <zmk/sensors.h>
+
+#include "../behaviors/runtime_sensor_rotate_accumulator.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+// Keys bound to CW and CCW in tests/split/native_posix_64.keymap
+#define SPLIT_CW_KEYCODE HID_USAGE_KEY_KEYBOARD_A
+#define SPLIT_CCW_KEYCODE HID_USAGE_KEY_KEYBOARD_B
+
+struct split_phase {
+    // Rotation per raw event in degrees, like EC11 style drivers report it
+    int8_t degrees;
+    uint8_t bursts;
+    uint8_t events_per_burst;
+};
+
+// Bursts span less than the aggregation interval and are further apart than it
+static const struct split_phase phases[] = {
+    {15, 6, 5},
+    {-20, 3, 4},
+};
+
+#define SPLIT_EVENT_SPACING_MS 1
+#define SPLIT_BURST_SPACING_MS 30
+
+static atomic_t cw_taps;
+static atomic_t ccw_taps;
+static atomic_t sent_events;
+
+static int split_keycode_listener(const zmk_event_t *eh) {
+    const struct zmk_keycode_state_changed *ev = as_zmk_keycode_state_changed(eh);
+    if (ev == NULL || !ev->state || ev->usage_page != HID_USAGE_KEY) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+    if (ev->keycode == SPLIT_CW_KEYCODE) {
+        atomic_inc(&cw_taps);
+    } else if (ev->keycode == SPLIT_CCW_KEYCODE) {
+        atomic_inc(&ccw_taps);
+    }
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(rsr_split_test_keycodes, split_keycode_listener);
+ZMK_SUBSCRIPTION(rsr_split_test_keycodes, zmk_keycode_state_changed);
+
+// Sorted after the aggregation, so it only sees what would cross the split link
+static int split_sensor_listener(const zmk_event_t *eh) {
+    if (as_zmk_sensor_event(eh) != NULL) {
+        atomic_inc(&sent_events);
+    }
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(rsr_split_test_sensors, split_sensor_listener);
+ZMK_SUBSCRIPTION(rsr_split_test_sensors, zmk_sensor_event);
+
+static void split_thread(void *p1, void *p2, void *p3) {
+    const struct zmk_sensor_config *config = zmk_sensors_get_config_at_index(0);
+    int64_t scale = rsr_accumulator_scale(config->triggers_per_rotation, 100);
+    int64_t remainder = 0;
+    int expected_cw = 0;
+    int expected_ccw = 0;
+    int raw_events = 0;
+
+    for (size_t p = 0; p < ARRAY_SIZE(phases); p++) {
+        for (int b = 0; b < phases[p].bursts; b++) {
+            for (int e = 0; e < phases[p].events_per_burst; e++) {
+                int triggers = rsr_accumulator_add(&remainder, phases[p].degrees, 0, scale);
+                if (triggers > 0) {
+                    expected_cw += triggers;
+                } else {
+                    expected_ccw -= triggers;
+                }
+
+                int rc = raise_zmk_sensor_event((struct zmk_sensor_event){
+                    .sensor_index = 0,
+                    .channel_data_size = 1,
+                    .channel_data = {{.channel = SENSOR_CHAN_ROTATION,
+                                      .value = {.val1 = phases[p].degrees}}},
+                    .timestamp = k_uptime_get(),
+                });
+                if (rc < 0) {
+                    printk("rsr_split_error: raising event failed %d\n", rc);
+                    return;
+                }
+                raw_events++;
+                k_msleep(SPLIT_EVENT_SPACING_MS);
+            }
+            k_msleep(SPLIT_BURST_SPACING_MS);
+        }
+    }
+
+    // Wait for the behavior queue to play back the remaining taps
+    k_msleep(200);
+
+    printk("rsr_split_done: raw=%d sent=%d cw=%d/%d ccw=%d/%d\n", raw_events,
+           (int)atomic_get(&sent_events), (int)atomic_get(&cw_taps), expected_cw,
+           (int)atomic_get(&ccw_taps), expected_ccw);
+}
+
+K_THREAD_DEFINE(rsr_split, 2048, split_thread, NULL, NULL, NULL, K_LOWEST_APPLICATION_THREAD_PRIO,
+                0, 0);
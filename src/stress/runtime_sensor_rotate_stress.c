@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Changes the runtime binding of a sensor back and forth from one thread while another injects
+// rotations, and checks that every invocation of the bound behavior carries a consistent
+// binding. The bindings point to probe behaviors which verify their params. Only meant for
+// native_posix, see tests/stress.
+
+#define DT_DRV_COMPAT zmk_behavior_runtime_sensor_rotate_stress_probe
+
+#include <zephyr/device.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include <drivers/behavior.h>
+#include <zmk/behavior.h>
+#include <zmk/keymap.h>
+#include <zmk/sensors.h>
+#include <zmk/virtual_key_position.h>
+#include <zmk/behaviors/runtime_sensor_rotate.h>
+
+#include "../behaviors/runtime_sensor_rotate_test.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#define STRESS_UPDATES CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_STRESS_TEST_UPDATES
+#define STRESS_TRIGGERS_PER_ROTATION 20
+#define STRESS_PARAM2_OFFSET 1000
+
+// Let the behavior queue and timers catch up every few events
+#define STRESS_EVENTS_PER_SLEEP 16
+
+struct stress_probe_config {
+    uint32_t probe_id;
+};
+
+static atomic_t probed;
+static atomic_t torn;
+static atomic_t writer_done;
+
+static int stress_probe_check(struct zmk_behavior_binding *binding) {
+    const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
+    const struct stress_probe_config *config = dev->config;
+
+    if (binding->param1 != config->probe_id ||
+        binding->param2 != config->probe_id + STRESS_PARAM2_OFFSET) {
+        LOG_ERR("Torn binding: %s param1=%d param2=%d", binding->behavior_dev, binding->param1,
+                binding->param2);
+        atomic_inc(&torn);
+    }
+    return ZMK_BEHAVIOR_OPAQUE;
+}
+
+static int stress_probe_pressed(struct zmk_behavior_binding *binding,
+                                struct zmk_behavior_binding_event event) {
+    atomic_inc(&probed);
+    return stress_probe_check(binding);
+}
+
+static int stress_probe_released(struct zmk_behavior_binding *binding,
+                                 struct zmk_behavior_binding_event event) {
+    return stress_probe_check(binding);
+}
+
+static const struct behavior_driver_api stress_probe_driver_api = {
+    .binding_pressed = stress_probe_pressed,
+    .binding_released = stress_probe_released,
+};
+
+#define STRESS_PROBE_INST(n)                                                                       \
+    static const struct stress_probe_config stress_probe_config_##n = {                            \
+        .probe_id = DT_INST_PROP(n, probe_id),                                                     \
+    };                                                                                             \
+    BEHAVIOR_DT_INST_DEFINE(n, NULL, NULL, NULL, &stress_probe_config_##n, POST_KERNEL,            \
+                            CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &stress_probe_driver_api);
+
+DT_INST_FOREACH_STATUS_OKAY(STRESS_PROBE_INST)
+
+static struct zmk_behavior_binding sensor_binding = {.behavior_dev = "rsr_stress"};
+
+static const struct zmk_sensor_config sensor_config = {
+    .triggers_per_rotation = STRESS_TRIGGERS_PER_ROTATION,
+};
+
+// Same sequence of calls as zmk_keymap_sensor_event for one event on a single layer keymap.
+// Returns whether the behavior queued a tap.
+static bool stress_sensor_event(int64_t timestamp) {
+    struct zmk_sensor_channel_data channel_data = {
+        .channel = SENSOR_CHAN_ROTATION,
+        .value = {.val1 = 360 / STRESS_TRIGGERS_PER_ROTATION},
+    };
+    struct zmk_behavior_binding_event event = {
+        .layer = 0,
+        .position = ZMK_VIRTUAL_KEY_POSITION_SENSOR(0),
+        .timestamp = timestamp,
+    };
+
+    behavior_sensor_keymap_binding_accept_data(&sensor_binding, event, &sensor_config, 1,
+                                               &channel_data);
+    return behavior_sensor_keymap_binding_process(&sensor_binding, event,
+                                                  BEHAVIOR_SENSOR_BINDING_PROCESS_MODE_TRIGGER) ==
+           ZMK_BEHAVIOR_OPAQUE;
+}
+
+static struct runtime_sensor_rotate_binding probe_binding(const char *name, uint32_t probe_id) {
+    return (struct runtime_sensor_rotate_binding){
+        .behavior_local_id = zmk_behavior_get_local_id(name),
+        .param1 = probe_id,
+        .param2 = probe_id + STRESS_PARAM2_OFFSET,
+    };
+}
+
+// Let the reader run between the words of a binding being published, like preemption on hardware
+// could
+void rsr_test_preempt(void) { k_yield(); }
+
+static void stress_writer(void *p1, void *p2, void *p3) {
+    const struct runtime_sensor_rotate_binding bindings[] = {
+        probe_binding("rsr_probe_a", DT_PROP(DT_NODELABEL(rsr_probe_a), probe_id)),
+        probe_binding("rsr_probe_b", DT_PROP(DT_NODELABEL(rsr_probe_b), probe_id)),
+    };
+
+    for (int i = 0; i < STRESS_UPDATES; i++) {
+        struct runtime_sensor_rotate_update update = {
+            .sensor_index = 0,
+            .layer = 0,
+            .type = RUNTIME_SENSOR_ROTATE_UPDATE_CW_BINDING,
+            .binding = bindings[i % ARRAY_SIZE(bindings)],
+        };
+        int rc = zmk_runtime_sensor_rotate_apply_updates(&update, 1);
+        if (rc != 0) {
+            printk("rsr_stress_error: update failed %d\n", rc);
+            break;
+        }
+    }
+    atomic_set(&writer_done, 1);
+}
+
+static void stress_reader(void *p1, void *p2, void *p3) {
+    uint32_t events = 0;
+    uint32_t taps = 0;
+    int64_t timestamp = 0;
+
+    // The writer yields in the middle of publishing a binding, which is when these run. Events
+    // before the first binding is published fall through.
+    while (!atomic_get(&writer_done)) {
+        if (stress_sensor_event(timestamp += 10)) {
+            taps++;
+        }
+        if (++events % STRESS_EVENTS_PER_SLEEP == 0) {
+            k_msleep(1);
+        } else {
+            k_yield();
+        }
+    }
+
+    // Wait for the behavior queue to play back the remaining taps
+    k_msleep(100);
+
+    printk("rsr_stress_done: torn=%d missed=%d\n", (int)atomic_get(&torn),
+           (int)(taps - atomic_get(&probed)));
+}
+
+K_THREAD_DEFINE(rsr_stress_writer, 2048, stress_writer, NULL, NULL, NULL,
+                K_LOWEST_APPLICATION_THREAD_PRIO, 0, 0);
+K_THREAD_DEFINE(rsr_stress_reader, 2048, stress_reader, NULL, NULL, NULL,
+                K_LOWEST_APPLICATION_THREAD_PRIO, 0, 0);
@@ -38,64 +38,33 @@ ZMK_RPC_CUSTOM_SUBSYSTEM(cormoran_rsr, &template_feature_meta, template_rpc_hand
 
 ZMK_RPC_CUSTOM_SUBSYSTEM_RESPONSE_BUFFER(cormoran_rsr, cormoran_rsr_Response);
 
-static int handle_set_layer_cw_binding(const cormoran_rsr_SetLayerCwBindingRequest *req,
-                                       cormoran_rsr_Response *resp);
-static int handle_set_layer_ccw_binding(const cormoran_rsr_SetLayerCcwBindingRequest *req,
-                                        cormoran_rsr_Response *resp);
-static int handle_get_all_layer_bindings(const cormoran_rsr_GetAllLayerBindingsRequest *req,
-                                         cormoran_rsr_Response *resp);
-static int handle_get_sensors(const cormoran_rsr_GetSensorsRequest *req,
-                              cormoran_rsr_Response *resp);
-
-/**
- * Main request handler for the custom RPC subsystem.
- * Sets up the encoding callback for the response.
- */
-static bool template_rpc_handle_request(const zmk_custom_CallRequest *raw_request,
-                                        pb_callback_t *encode_response) {
-    cormoran_rsr_Response *resp =
-        ZMK_RPC_CUSTOM_SUBSYSTEM_RESPONSE_BUFFER_ALLOCATE(cormoran_rsr, encode_response);
-
-    cormoran_rsr_Request req = cormoran_rsr_Request_init_zero;
-
-    // Decode the incoming request from the raw payload
-    pb_istream_t req_stream =
-        pb_istream_from_buffer(raw_request->payload.bytes, raw_request->payload.size);
-    if (!pb_decode(&req_stream, cormoran_rsr_Request_fields, &req)) {
-        LOG_WRN("Failed to decode template request: %s", PB_GET_ERROR(&req_stream));
-        cormoran_rsr_ErrorResponse err = cormoran_rsr_ErrorResponse_init_zero;
-        snprintf(err.message, sizeof(err.message), "Failed to decode request");
-        resp->which_response_type = cormoran_rsr_Response_error_tag;
-        resp->response_type.error = err;
-        return true;
-    }
-
-    int rc = 0;
-    switch (req.which_request_type) {
-    case cormoran_rsr_Request_set_layer_cw_binding_tag:
-        rc = handle_set_layer_cw_binding(&req.request_type.set_layer_cw_binding, resp);
-        break;
-    case cormoran_rsr_Request_set_layer_ccw_binding_tag:
-        rc = handle_set_layer_ccw_binding(&req.request_type.set_layer_ccw_binding, resp);
-        break;
-    case cormoran_rsr_Request_get_all_layer_bindings_tag:
-        rc = handle_get_all_layer_bindings(&req.request_type.get_all_layer_bindings, resp);
-        break;
-    case cormoran_rsr_Request_get_sensors_tag:
-        rc = handle_get_sensors(&req.request_type.get_sensors, resp);
-        break;
-    default:
-        LOG_WRN("Unsupported template request type: %d", req.which_request_type);
-        rc = -1;
-    }
+// Events per DrainEvents response, the web UI polls again right away after a full one
+#define DRAIN_EVENTS_MAX 16
+
+static void from_proto_binding(const cormoran_rsr_Binding *binding,
+                               struct runtime_sensor_rotate_binding *out) {
+    out->behavior_local_id = binding->behavior_id;
+    out->param1 = binding->param1;
+    out->param2 = binding->param2;
+    out->tap_ms = MIN(binding->tap_ms, UINT16_MAX);
+    out->hold_ms = MIN(binding->hold_ms, UINT16_MAX);
+}
 
-    if (rc != 0) {
-        cormoran_rsr_ErrorResponse err = cormoran_rsr_ErrorResponse_init_zero;
-        snprintf(err.message, sizeof(err.message), "Failed to process request");
-        resp->which_response_type = cormoran_rsr_Response_error_tag;
-        resp->response_type.error = err;
+// Change one direction of the runtime binding of a layer, channel 0. The other direction keeps
+// its runtime binding, or none, rather than taking over the keymap default.
+static int set_layer_direction_binding(uint32_t sensor_index, uint32_t layer,
+                                       enum runtime_sensor_rotate_update_type type,
+                                       const cormoran_rsr_Binding *binding) {
+    if (sensor_index > UINT8_MAX || layer > UINT8_MAX) {
+        return -EINVAL;
     }
-    return true;
+    struct runtime_sensor_rotate_update update = {
+        .sensor_index = sensor_index,
+        .layer = layer,
+        .type = type,
+    };
+    from_proto_binding(binding, &update.binding);
+    return zmk_runtime_sensor_rotate_apply_updates(&update, 1);
 }
 
 static int handle_set_layer_cw_binding(const cormoran_rsr_SetLayerCwBindingRequest *req,
@@ -108,26 +77,13 @@ static int handle_set_layer_cw_binding(const cormoran_rsr_SetLayerCwBindingReque
         return -EINVAL;
     }
 
-    struct runtime_sensor_rotate_layer_bindings binding = {};
-    int rc = zmk_runtime_sensor_rotate_get_bindings(req->sensor_index, req->layer, &binding);
-    if (rc != 0) {
-        // On error, we'll start with all zeros (already initialized above)
-        LOG_WRN("Failed to get existing bindings, will create new binding for layer %d",
-                req->layer);
-        return -1;
-    }
-
-    // Update only CW binding for the requested layer
-    binding.cw_binding.behavior_local_id = req->binding.behavior_id;
-    binding.cw_binding.param1 = req->binding.param1;
-    binding.cw_binding.param2 = req->binding.param2;
-    binding.cw_binding.tap_ms = req->binding.tap_ms;
-
-    rc = zmk_runtime_sensor_rotate_set_layer_bindings(req->sensor_index, req->layer, &binding);
+    int rc = set_layer_direction_binding(req->sensor_index, req->layer,
+                                         RUNTIME_SENSOR_ROTATE_UPDATE_CW_BINDING, &req->binding);
 
     cormoran_rsr_SetLayerCwBindingResponse result =
         cormoran_rsr_SetLayerCwBindingResponse_init_zero;
     result.success = (rc == 0);
+    result.generation = zmk_runtime_sensor_rotate_get_generation(req->sensor_index);
 
     resp->which_response_type = cormoran_rsr_Response_set_layer_cw_binding_tag;
     resp->response_type.set_layer_cw_binding = result;
@@ -144,66 +100,126 @@ static int handle_set_layer_ccw_binding(const cormoran_rsr_SetLayerCcwBindingReq
         return -EINVAL;
     }
 
-    struct runtime_sensor_rotate_layer_bindings binding = {};
-    int rc = zmk_runtime_sensor_rotate_get_bindings(req->sensor_index, req->layer, &binding);
-    if (rc != 0) {
-        // On error, we'll start with all zeros (already initialized above)
-        LOG_WRN("Failed to get existing bindings, will create new binding for layer %d",
-                req->layer);
-        return -1;
-    }
-
-    // Update only CCW binding for the requested layer
-    binding.ccw_binding.behavior_local_id = req->binding.behavior_id;
-    binding.ccw_binding.param1 = req->binding.param1;
-    binding.ccw_binding.param2 = req->binding.param2;
-    binding.ccw_binding.tap_ms = req->binding.tap_ms;
-
-    rc = zmk_runtime_sensor_rotate_set_layer_bindings(req->sensor_index, req->layer, &binding);
+    int rc = set_layer_direction_binding(req->sensor_index, req->layer,
+                                         RUNTIME_SENSOR_ROTATE_UPDATE_CCW_BINDING, &req->binding);
 
     cormoran_rsr_SetLayerCcwBindingResponse result =
         cormoran_rsr_SetLayerCcwBindingResponse_init_zero;
     result.success = (rc == 0);
+    result.generation = zmk_runtime_sensor_rotate_get_generation(req->sensor_index);
 
     resp->which_response_type = cormoran_rsr_Response_set_layer_ccw_binding_tag;
     resp->response_type.set_layer_ccw_binding = result;
     return rc;
 }
 
-static int handle_get_all_layer_bindings(const cormoran_rsr_GetAllLayerBindingsRequest *req,
-                                         cormoran_rsr_Response *resp) {
-    LOG_DBG("Get all layer bindings: sensor=%d", req->sensor_index);
-
-    struct runtime_sensor_rotate_layer_bindings bindings[ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS];
-    uint8_t actual_layers;
-
-    int rc = zmk_runtime_sensor_rotate_get_all_layer_bindings(
-        req->sensor_index, ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS, bindings, &actual_layers);
+static void to_proto_binding(const struct runtime_sensor_rotate_binding *binding,
+                             cormoran_rsr_Binding *out) {
+    // Convert local_id to behavior_id (they are the same)
+    out->behavior_id = binding->behavior_local_id;
+    out->param1 = binding->param1;
+    out->param2 = binding->param2;
+    out->tap_ms = binding->tap_ms;
+    out->hold_ms = binding->hold_ms;
+}
 
+// Fill bindings and acceleration of a layer of a sensor channel
+static int fill_layer_bindings(uint8_t sensor_index, uint8_t channel, uint8_t layer,
+                               cormoran_rsr_LayerBindings *out) {
+    struct runtime_sensor_rotate_layer_bindings bindings;
+    int rc =
+        zmk_runtime_sensor_rotate_get_channel_bindings(sensor_index, channel, layer, &bindings);
     if (rc != 0) {
-        LOG_ERR("Failed to get all layer bindings: %d", rc);
         return rc;
     }
 
-    cormoran_rsr_GetAllLayerBindingsResponse result =
-        cormoran_rsr_GetAllLayerBindingsResponse_init_zero;
-    result.bindings_count = actual_layers;
+    out->layer = layer;
+
+    out->has_cw_binding = true; // required to serialize field
+    to_proto_binding(&bindings.cw_binding, &out->cw_binding);
+    out->has_ccw_binding = true;
+    to_proto_binding(&bindings.ccw_binding, &out->ccw_binding);
+
+    struct runtime_sensor_rotate_acceleration accel = {};
+    zmk_runtime_sensor_rotate_get_channel_acceleration(sensor_index, channel, layer, &accel);
+    out->has_acceleration = true;
+    out->acceleration.threshold_ms = accel.threshold_ms;
+    out->acceleration.multiplier = accel.multiplier;
+    out->acceleration.max_triggers = accel.max_triggers;
+    return 0;
+}
+
+// Repeated fields are encoded by callbacks that read the behavior's tables one entry at a time
+// while the response is written out, so neither the stack nor the response buffer grows with
+// the number of layers and sensors. nanopb calls them more than once per response, to size the
+// submessages first, so they check that the configuration didn't change in between.
+
+struct layer_bindings_source {
+    uint8_t sensor_index;
+    uint8_t channel;
+    // Generation of the sensor the GetAllLayerBindings response was made for
+    uint32_t generation;
+};
 
-    for (uint8_t i = 0; i < actual_layers; i++) {
-        result.bindings[i].layer = i;
+static bool encode_layer_bindings(pb_ostream_t *stream, const pb_field_t *field,
+                                  void *const *arg) {
+    const struct layer_bindings_source *source = *arg;
+
+    for (uint8_t layer = 0; layer < ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS; layer++) {
+        cormoran_rsr_LayerBindings out = cormoran_rsr_LayerBindings_init_zero;
+        if (fill_layer_bindings(source->sensor_index, source->channel, layer, &out) != 0) {
+            return false;
+        }
+        if (!pb_encode_tag_for_field(stream, field) ||
+            !pb_encode_submessage(stream, cormoran_rsr_LayerBindings_fields, &out)) {
+            return false;
+        }
+    }
+    return true;
+}
 
-        // Convert local_id to behavior_id (they are the same)
-        result.bindings[i].has_cw_binding = true; // required to serialize field
-        result.bindings[i].cw_binding.behavior_id = bindings[i].cw_binding.behavior_local_id;
-        result.bindings[i].cw_binding.param1 = bindings[i].cw_binding.param1;
-        result.bindings[i].cw_binding.param2 = bindings[i].cw_binding.param2;
-        result.bindings[i].cw_binding.tap_ms = bindings[i].cw_binding.tap_ms;
+// Sensor channel of the GetAllLayerBindings response being encoded
+static struct layer_bindings_source sensor_layer_bindings_source;
 
-        result.bindings[i].has_ccw_binding = true;
-        result.bindings[i].ccw_binding.behavior_id = bindings[i].ccw_binding.behavior_local_id;
-        result.bindings[i].ccw_binding.param1 = bindings[i].ccw_binding.param1;
-        result.bindings[i].ccw_binding.param2 = bindings[i].ccw_binding.param2;
-        result.bindings[i].ccw_binding.tap_ms = bindings[i].ccw_binding.tap_ms;
+static bool encode_sensor_layer_bindings(pb_ostream_t *stream, const pb_field_t *field,
+                                         void *const *arg) {
+    const struct layer_bindings_source *source = *arg;
+
+    if (zmk_runtime_sensor_rotate_get_generation(source->sensor_index) != source->generation) {
+        LOG_WRN("Bindings of sensor %d changed while encoding", source->sensor_index);
+        return false;
+    }
+    return encode_layer_bindings(stream, field, arg);
+}
+
+static int handle_get_all_layer_bindings(const cormoran_rsr_GetAllLayerBindingsRequest *req,
+                                         cormoran_rsr_Response *resp) {
+    uint32_t channel = req->has_channel ? req->channel : 0;
+    LOG_DBG("Get all layer bindings: sensor=%d channel=%d", req->sensor_index, channel);
+
+    if (req->sensor_index >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS) {
+        LOG_ERR("Sensor index %d out of bounds", req->sensor_index);
+        return -EINVAL;
+    }
+    if (channel >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_CHANNELS) {
+        LOG_ERR("Channel %d out of bounds", channel);
+        return -EINVAL;
+    }
+
+    cormoran_rsr_GetAllLayerBindingsResponse result =
+        cormoran_rsr_GetAllLayerBindingsResponse_init_zero;
+    result.generation = zmk_runtime_sensor_rotate_get_generation(req->sensor_index);
+
+    if (req->has_if_changed_since && req->if_changed_since == result.generation) {
+        result.not_modified = true;
+    } else {
+        sensor_layer_bindings_source = (struct layer_bindings_source){
+            .sensor_index = req->sensor_index,
+            .channel = channel,
+            .generation = result.generation,
+        };
+        result.bindings.funcs.encode = encode_sensor_layer_bindings;
+        result.bindings.arg = &sensor_layer_bindings_source;
     }
 
     resp->which_response_type = cormoran_rsr_Response_get_all_layer_bindings_tag;
@@ -211,6 +227,289 @@ static int handle_get_all_layer_bindings(const cormoran_rsr_GetAllLayerBindingsR
     return 0;
 }
 
+// Global generation of the GetAllBindings response being encoded
+static uint32_t all_bindings_generation;
+
+static bool encode_sensor_bindings(pb_ostream_t *stream, const pb_field_t *field,
+                                   void *const *arg) {
+    if (zmk_runtime_sensor_rotate_get_global_generation() != all_bindings_generation) {
+        LOG_WRN("Bindings changed while encoding");
+        return false;
+    }
+
+    // One entry per sensor channel
+    for (uint8_t s = 0; s < ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS; s++) {
+        for (uint8_t c = 0; c < ZMK_RUNTIME_SENSOR_ROTATE_MAX_CHANNELS; c++) {
+            struct layer_bindings_source source = {.sensor_index = s, .channel = c};
+            cormoran_rsr_SensorBindings sensor = cormoran_rsr_SensorBindings_init_zero;
+            sensor.sensor_index = s;
+            sensor.channel = c;
+            sensor.generation = zmk_runtime_sensor_rotate_get_generation(s);
+            sensor.layers.funcs.encode = encode_layer_bindings;
+            sensor.layers.arg = &source;
+
+            if (!pb_encode_tag_for_field(stream, field) ||
+                !pb_encode_submessage(stream, cormoran_rsr_SensorBindings_fields, &sensor)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static int handle_get_all_bindings(const cormoran_rsr_GetAllBindingsRequest *req,
+                                   cormoran_rsr_Response *resp) {
+    LOG_DBG("Get all bindings");
+
+    cormoran_rsr_GetAllBindingsResponse result = cormoran_rsr_GetAllBindingsResponse_init_zero;
+    result.generation = zmk_runtime_sensor_rotate_get_global_generation();
+
+    if (req->has_if_changed_since && req->if_changed_since == result.generation) {
+        result.not_modified = true;
+    } else {
+        all_bindings_generation = result.generation;
+        result.sensors.funcs.encode = encode_sensor_bindings;
+    }
+
+    resp->which_response_type = cormoran_rsr_Response_get_all_bindings_tag;
+    resp->response_type.get_all_bindings = result;
+    return 0;
+}
+
+static int handle_set_bindings(const cormoran_rsr_SetBindingsRequest *req,
+                               cormoran_rsr_Response *resp) {
+    LOG_DBG("Set bindings: %d bindings, %d accelerations", req->updates_count,
+            req->acceleration_updates_count);
+
+    static struct runtime_sensor_rotate_update
+        updates[ARRAY_SIZE(req->updates) + ARRAY_SIZE(req->acceleration_updates)];
+    size_t count = 0;
+
+    for (pb_size_t i = 0; i < req->updates_count; i++) {
+        const cormoran_rsr_BindingUpdate *update = &req->updates[i];
+        if (update->sensor_index > UINT8_MAX || update->channel > UINT8_MAX ||
+            update->layer > UINT8_MAX) {
+            return -EINVAL;
+        }
+        updates[count] = (struct runtime_sensor_rotate_update){
+            .sensor_index = update->sensor_index,
+            .channel = update->channel,
+            .layer = update->layer,
+            .type = update->direction == cormoran_rsr_Direction_DIRECTION_CCW
+                        ? RUNTIME_SENSOR_ROTATE_UPDATE_CCW_BINDING
+                        : RUNTIME_SENSOR_ROTATE_UPDATE_CW_BINDING,
+        };
+        from_proto_binding(&update->binding, &updates[count].binding);
+        count++;
+    }
+
+    for (pb_size_t i = 0; i < req->acceleration_updates_count; i++) {
+        const cormoran_rsr_AccelerationUpdate *update = &req->acceleration_updates[i];
+        if (update->sensor_index > UINT8_MAX || update->channel > UINT8_MAX ||
+            update->layer > UINT8_MAX) {
+            return -EINVAL;
+        }
+        updates[count] = (struct runtime_sensor_rotate_update){
+            .sensor_index = update->sensor_index,
+            .channel = update->channel,
+            .layer = update->layer,
+            .type = RUNTIME_SENSOR_ROTATE_UPDATE_ACCELERATION,
+            .acceleration =
+                {
+                    .threshold_ms = MIN(update->acceleration.threshold_ms, UINT16_MAX),
+                    .multiplier = MIN(update->acceleration.multiplier, UINT16_MAX),
+                    .max_triggers = MIN(update->acceleration.max_triggers, UINT16_MAX),
+                },
+        };
+        count++;
+    }
+
+    int rc = zmk_runtime_sensor_rotate_apply_updates(updates, count);
+
+    cormoran_rsr_SetBindingsResponse result = cormoran_rsr_SetBindingsResponse_init_zero;
+    result.success = (rc == 0);
+    result.generation = zmk_runtime_sensor_rotate_get_global_generation();
+
+    resp->which_response_type = cormoran_rsr_Response_set_bindings_tag;
+    resp->response_type.set_bindings = result;
+    return rc;
+}
+
+static int handle_set_layer_acceleration(const cormoran_rsr_SetLayerAccelerationRequest *req,
+                                         cormoran_rsr_Response *resp) {
+    LOG_DBG("Set layer acceleration: sensor=%d layer=%d", req->sensor_index, req->layer);
+
+    // Validate layer bounds
+    if (req->layer >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS) {
+        LOG_ERR("Layer %d exceeds max layers %d", req->layer, ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS);
+        return -EINVAL;
+    }
+
+    struct runtime_sensor_rotate_acceleration accel = {
+        .threshold_ms = MIN(req->acceleration.threshold_ms, UINT16_MAX),
+        .multiplier = MIN(req->acceleration.multiplier, UINT16_MAX),
+        .max_triggers = MIN(req->acceleration.max_triggers, UINT16_MAX),
+    };
+
+    int rc = zmk_runtime_sensor_rotate_set_acceleration(req->sensor_index, req->layer, &accel);
+
+    cormoran_rsr_SetLayerAccelerationResponse result =
+        cormoran_rsr_SetLayerAccelerationResponse_init_zero;
+    result.success = (rc == 0);
+    result.generation = zmk_runtime_sensor_rotate_get_generation(req->sensor_index);
+
+    resp->which_response_type = cormoran_rsr_Response_set_layer_acceleration_tag;
+    resp->response_type.set_layer_acceleration = result;
+    return rc;
+}
+
+static int handle_save_changes(const cormoran_rsr_SaveChangesRequest *req,
+                               cormoran_rsr_Response *resp) {
+    LOG_DBG("Save changes");
+
+    int rc = zmk_runtime_sensor_rotate_save_changes();
+
+    cormoran_rsr_SaveChangesResponse result = cormoran_rsr_SaveChangesResponse_init_zero;
+    result.success = (rc == 0);
+
+    resp->which_response_type = cormoran_rsr_Response_save_changes_tag;
+    resp->response_type.save_changes = result;
+    return rc;
+}
+
+static int handle_discard_changes(const cormoran_rsr_DiscardChangesRequest *req,
+                                  cormoran_rsr_Response *resp) {
+    LOG_DBG("Discard changes");
+
+    int rc = zmk_runtime_sensor_rotate_discard_changes();
+
+    cormoran_rsr_DiscardChangesResponse result = cormoran_rsr_DiscardChangesResponse_init_zero;
+    result.success = (rc == 0);
+
+    resp->which_response_type = cormoran_rsr_Response_discard_changes_tag;
+    resp->response_type.discard_changes = result;
+    return rc;
+}
+
+static int handle_check_unsaved_changes(const cormoran_rsr_CheckUnsavedChangesRequest *req,
+                                        cormoran_rsr_Response *resp) {
+    cormoran_rsr_CheckUnsavedChangesResponse result =
+        cormoran_rsr_CheckUnsavedChangesResponse_init_zero;
+    result.unsaved_changes = zmk_runtime_sensor_rotate_has_unsaved_changes();
+
+    resp->which_response_type = cormoran_rsr_Response_check_unsaved_changes_tag;
+    resp->response_type.check_unsaved_changes = result;
+    return 0;
+}
+
+static int handle_get_stats(const cormoran_rsr_GetStatsRequest *req, cormoran_rsr_Response *resp) {
+    if (req->sensor_index >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS) {
+        LOG_ERR("Sensor index %d out of bounds", req->sensor_index);
+        return -EINVAL;
+    }
+
+    cormoran_rsr_GetStatsResponse *result = &resp->response_type.get_stats;
+    *result = (cormoran_rsr_GetStatsResponse)cormoran_rsr_GetStatsResponse_init_zero;
+    resp->which_response_type = cormoran_rsr_Response_get_stats_tag;
+
+#if IS_ENABLED(CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_STATS)
+    result->enabled = true;
+    for (uint32_t layer = req->layer_offset; layer < ZMK_RUNTIME_SENSOR_ROTATE_MAX_LAYERS;
+         layer++) {
+        if (result->layers_count == ARRAY_SIZE(result->layers)) {
+            // The client asks for the rest with the next request
+            result->truncated = true;
+            result->next_layer_offset = layer;
+            break;
+        }
+        struct runtime_sensor_rotate_stats stats;
+        if (zmk_runtime_sensor_rotate_get_stats(req->sensor_index, layer, &stats) != 0) {
+            continue;
+        }
+
+        cormoran_rsr_LayerStats *out = &result->layers[result->layers_count++];
+        *out = (cormoran_rsr_LayerStats)cormoran_rsr_LayerStats_init_zero;
+        out->layer = layer;
+        out->events_accepted = stats.events_accepted;
+        out->cw_triggers = stats.cw_triggers;
+        out->ccw_triggers = stats.ccw_triggers;
+        out->transparent = stats.transparent;
+        out->lookup_failures = stats.lookup_failures;
+        out->max_triggers_per_event = stats.max_triggers_per_event;
+        out->process_count = stats.process_count;
+        if (stats.process_count > 0) {
+            out->process_avg_ns =
+                k_cyc_to_ns_floor64(stats.process_cycles_total / stats.process_count);
+        }
+        out->process_max_ns = k_cyc_to_ns_floor64(stats.process_cycles_max);
+        out->tap_bursts = stats.tap_bursts;
+        out->shortened_events = stats.shortened_events;
+        out->last_tap_ms = stats.last_tap_ms;
+        out->min_tap_ms = stats.min_tap_ms;
+    }
+#endif
+    return 0;
+}
+
+static int handle_reset_stats(const cormoran_rsr_ResetStatsRequest *req,
+                              cormoran_rsr_Response *resp) {
+    cormoran_rsr_ResetStatsResponse result = cormoran_rsr_ResetStatsResponse_init_zero;
+#if IS_ENABLED(CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_STATS)
+    zmk_runtime_sensor_rotate_reset_stats();
+    result.success = true;
+#endif
+
+    resp->which_response_type = cormoran_rsr_Response_reset_stats_tag;
+    resp->response_type.reset_stats = result;
+    return 0;
+}
+
+static int handle_set_sensor_resolution(const cormoran_rsr_SetSensorResolutionRequest *req,
+                                        cormoran_rsr_Response *resp) {
+    LOG_DBG("Set sensor resolution: sensor=%d resolution=%d", req->sensor_index,
+            req->resolution_percent);
+
+    if (req->sensor_index >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS) {
+        LOG_ERR("Sensor index %d out of bounds", req->sensor_index);
+        return -EINVAL;
+    }
+
+    int rc = zmk_runtime_sensor_rotate_set_resolution(
+        req->sensor_index, MIN(req->resolution_percent, UINT16_MAX));
+
+    cormoran_rsr_SetSensorResolutionResponse result =
+        cormoran_rsr_SetSensorResolutionResponse_init_zero;
+    result.success = (rc == 0);
+    result.generation = zmk_runtime_sensor_rotate_get_generation(req->sensor_index);
+
+    resp->which_response_type = cormoran_rsr_Response_set_sensor_resolution_tag;
+    resp->response_type.set_sensor_resolution = result;
+    return rc;
+}
+
+static int handle_set_sensor_max_latency(const cormoran_rsr_SetSensorMaxLatencyRequest *req,
+                                         cormoran_rsr_Response *resp) {
+    LOG_DBG("Set sensor max latency: sensor=%d max_latency_ms=%d", req->sensor_index,
+            req->max_latency_ms);
+
+    if (req->sensor_index >= ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS) {
+        LOG_ERR("Sensor index %d out of bounds", req->sensor_index);
+        return -EINVAL;
+    }
+
+    int rc = zmk_runtime_sensor_rotate_set_max_latency(req->sensor_index,
+                                                       MIN(req->max_latency_ms, UINT16_MAX));
+
+    cormoran_rsr_SetSensorMaxLatencyResponse result =
+        cormoran_rsr_SetSensorMaxLatencyResponse_init_zero;
+    result.success = (rc == 0);
+    result.generation = zmk_runtime_sensor_rotate_get_generation(req->sensor_index);
+
+    resp->which_response_type = cormoran_rsr_Response_set_sensor_max_latency_tag;
+    resp->response_type.set_sensor_max_latency = result;
+    return rc;
+}
+
 #if ZMK_KEYMAP_HAS_SENSORS
 
 #define _SENSOR_NAME(idx, node) DT_NODE_FULL_NAME(node)
@@ -220,24 +519,232 @@ static const char *sensor_names[] = {LISTIFY(ZMK_KEYMAP_SENSORS_LEN, SENSOR_NAME
 
 #endif
 
+#if ZMK_KEYMAP_HAS_SENSORS
+
+static bool encode_sensor_name(pb_ostream_t *stream, const pb_field_t *field, void *const *arg) {
+    const char *name = *arg;
+    return pb_encode_tag_for_field(stream, field) &&
+           pb_encode_string(stream, (const pb_byte_t *)name, strlen(name));
+}
+
+static bool encode_sensors(pb_ostream_t *stream, const pb_field_t *field, void *const *arg) {
+    // Only the sensors with runtime configuration, the others keep their devicetree bindings
+    for (uint8_t i = 0; i < ZMK_RUNTIME_SENSOR_ROTATE_MAX_SENSORS; i++) {
+        cormoran_rsr_SensorInfo sensor = cormoran_rsr_SensorInfo_init_zero;
+        sensor.index = i;
+        sensor.name.funcs.encode = encode_sensor_name;
+        sensor.name.arg = (void *)sensor_names[i];
+        sensor.resolution_percent = zmk_runtime_sensor_rotate_get_resolution(i);
+        sensor.max_latency_ms = zmk_runtime_sensor_rotate_get_max_latency(i);
+        sensor.channels = ZMK_RUNTIME_SENSOR_ROTATE_MAX_CHANNELS;
+
+        if (!pb_encode_tag_for_field(stream, field) ||
+            !pb_encode_submessage(stream, cormoran_rsr_SensorInfo_fields, &sensor)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif
+
 static int handle_get_sensors(const cormoran_rsr_GetSensorsRequest *req,
                               cormoran_rsr_Response *resp) {
     LOG_DBG("Get sensors");
 
     cormoran_rsr_GetSensorsResponse result = cormoran_rsr_GetSensorsResponse_init_zero;
-
 #if ZMK_KEYMAP_HAS_SENSORS
-    result.sensors_count = ZMK_KEYMAP_SENSORS_LEN;
-
-    for (uint8_t i = 0; i < ZMK_KEYMAP_SENSORS_LEN; i++) {
-        result.sensors[i].index = i;
-        strncpy(result.sensors[i].name, sensor_names[i], sizeof(result.sensors[i].name) - 1);
-    }
-#else
-    result.sensors_count = 0;
+    result.sensors.funcs.encode = encode_sensors;
 #endif
 
     resp->which_response_type = cormoran_rsr_Response_get_sensors_tag;
     resp->response_type.get_sensors = result;
     return 0;
 }
+
+#if IS_ENABLED(CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_EVENT_LOG)
+
+// Events of the DrainEvents response being encoded. Drained once by the handler, draining again
+// while encoding would return other events.
+static struct runtime_sensor_rotate_event_record drained_events[DRAIN_EVENTS_MAX];
+static int drained_events_count;
+
+static bool encode_drained_events(pb_ostream_t *stream, const pb_field_t *field,
+                                  void *const *arg) {
+    for (int i = 0; i < drained_events_count; i++) {
+        const struct runtime_sensor_rotate_event_record *record = &drained_events[i];
+        cormoran_rsr_RotationEvent out = cormoran_rsr_RotationEvent_init_zero;
+        out.sequence = record->sequence;
+        out.timestamp_ms = record->timestamp_ms;
+        out.sensor_index = record->sensor_index;
+        out.channel = record->channel;
+        out.layer = record->layer;
+        out.val1 = record->val1;
+        out.val2 = record->val2;
+        out.remainder_milli = record->remainder_milli;
+        out.triggers = record->triggers;
+        out.transparent = record->transparent;
+        if (record->binding.behavior_local_id != 0) {
+            out.has_binding = true;
+            to_proto_binding(&record->binding, &out.binding);
+        }
+
+        if (!pb_encode_tag_for_field(stream, field) ||
+            !pb_encode_submessage(stream, cormoran_rsr_RotationEvent_fields, &out)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif
+
+static int handle_drain_events(const cormoran_rsr_DrainEventsRequest *req,
+                               cormoran_rsr_Response *resp) {
+    cormoran_rsr_DrainEventsResponse result = cormoran_rsr_DrainEventsResponse_init_zero;
+
+#if IS_ENABLED(CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_EVENT_LOG)
+    drained_events_count = zmk_runtime_sensor_rotate_drain_events(
+        req->since_sequence, drained_events, ARRAY_SIZE(drained_events), &result.next_sequence,
+        &result.dropped);
+
+    result.enabled = true;
+    result.events.funcs.encode = encode_drained_events;
+#endif
+
+    resp->which_response_type = cormoran_rsr_Response_drain_events_tag;
+    resp->response_type.drain_events = result;
+    return 0;
+}
+
+static int handle_get_profiles(const cormoran_rsr_GetProfilesRequest *req,
+                               cormoran_rsr_Response *resp) {
+    cormoran_rsr_GetProfilesResponse result = cormoran_rsr_GetProfilesResponse_init_zero;
+    result.count = ZMK_RUNTIME_SENSOR_ROTATE_PROFILES;
+    result.active = zmk_runtime_sensor_rotate_get_active_profile();
+
+    resp->which_response_type = cormoran_rsr_Response_get_profiles_tag;
+    resp->response_type.get_profiles = result;
+    return 0;
+}
+
+static int handle_set_active_profile(const cormoran_rsr_SetActiveProfileRequest *req,
+                                     cormoran_rsr_Response *resp) {
+    LOG_DBG("Set active profile: profile=%d", req->profile);
+
+    if (req->profile >= ZMK_RUNTIME_SENSOR_ROTATE_PROFILES) {
+        LOG_ERR("Profile %d out of bounds", req->profile);
+        return -EINVAL;
+    }
+
+    int rc = zmk_runtime_sensor_rotate_set_active_profile(req->profile);
+
+    cormoran_rsr_SetActiveProfileResponse result = cormoran_rsr_SetActiveProfileResponse_init_zero;
+    result.success = (rc == 0);
+    result.active = zmk_runtime_sensor_rotate_get_active_profile();
+    result.generation = zmk_runtime_sensor_rotate_get_global_generation();
+
+    resp->which_response_type = cormoran_rsr_Response_set_active_profile_tag;
+    resp->response_type.set_active_profile = result;
+    return rc;
+}
+
+// Blob of the export being read or the import being received, in chunks. The buffer holds one
+// transfer at a time and only takes chunks of that one.
+static uint8_t config_blob[CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_CONFIG_BLOB_SIZE];
+static size_t config_blob_len;
+
+enum config_blob_transfer {
+    CONFIG_BLOB_IDLE,
+    CONFIG_BLOB_EXPORTING,
+    CONFIG_BLOB_IMPORTING,
+};
+
+static enum config_blob_transfer config_blob_transfer;
+static int64_t config_blob_last_chunk;
+
+// An import without a chunk for this long is taken as abandoned and no longer blocks exports
+#define CONFIG_BLOB_IMPORT_TIMEOUT_MS 5000
+
+static void config_blob_start(enum config_blob_transfer transfer) {
+    config_blob_transfer = transfer;
+    config_blob_len = 0;
+    config_blob_last_chunk = k_uptime_get();
+}
+
+static int handle_export_config(const cormoran_rsr_ExportConfigRequest *req,
+                                cormoran_rsr_Response *resp) {
+    LOG_DBG("Export config: offset=%d", req->offset);
+
+    if (req->offset == 0) {
+        if (config_blob_transfer == CONFIG_BLOB_IMPORTING &&
+            k_uptime_get() - config_blob_last_chunk < CONFIG_BLOB_IMPORT_TIMEOUT_MS) {
+            LOG_ERR("Can't export while an import is being received");
+            return -EBUSY;
+        }
+        config_blob_start(CONFIG_BLOB_EXPORTING);
+        int rc = zmk_runtime_sensor_rotate_export_config(config_blob, sizeof(config_blob));
+        if (rc < 0) {
+            LOG_ERR("Failed to export config: %d", rc);
+            config_blob_transfer = CONFIG_BLOB_IDLE;
+            return rc;
+        }
+        config_blob_len = rc;
+    } else if (config_blob_transfer != CONFIG_BLOB_EXPORTING) {
+        LOG_ERR("Export chunk at %d without an export in progress", req->offset);
+        return -EINVAL;
+    }
+    if (req->offset > config_blob_len) {
+        LOG_ERR("Export offset %d out of bounds", req->offset);
+        return -EINVAL;
+    }
+
+    cormoran_rsr_ExportConfigResponse *result = &resp->response_type.export_config;
+    *result = (cormoran_rsr_ExportConfigResponse)cormoran_rsr_ExportConfigResponse_init_zero;
+    result->success = true;
+    result->offset = req->offset;
+    result->total_size = config_blob_len;
+    result->data.size = MIN(config_blob_len - req->offset, sizeof(result->data.bytes));
+    memcpy(result->data.bytes, config_blob + req->offset, result->data.size);
+
+    resp->which_response_type = cormoran_rsr_Response_export_config_tag;
+    return 0;
+}
+
+static int handle_import_config(const cormoran_rsr_ImportConfigRequest *req,
+                                cormoran_rsr_Response *resp) {
+    LOG_DBG("Import config: offset=%d total_size=%d", req->offset, req->total_size);
+
+    // A new import replaces an export or an earlier import, which can be restarted
+    if (req->offset == 0) {
+        config_blob_start(CONFIG_BLOB_IMPORTING);
+    }
+    if (config_blob_transfer != CONFIG_BLOB_IMPORTING) {
+        LOG_ERR("Import chunk at %d without an import in progress", req->offset);
+        return -EINVAL;
+    }
+    if (req->offset != config_blob_len || req->total_size > sizeof(config_blob) ||
+        req->offset + req->data.size > req->total_size) {
+        LOG_ERR("Unexpected import chunk at %d of %d", req->offset, req->total_size);
+        config_blob_transfer = CONFIG_BLOB_IDLE;
+        return -EINVAL;
+    }
+    memcpy(config_blob + req->offset, req->data.bytes, req->data.size);
+    config_blob_len += req->data.size;
+    config_blob_last_chunk = k_uptime_get();
+
+    cormoran_rsr_ImportConfigResponse result = cormoran_rsr_ImportConfigResponse_init_zero;
+    result.success = true;
+    int rc = 0;
+    if (config_blob_len == req->total_size) {
+        rc = zmk_runtime_sensor_rotate_import_config(config_blob, config_blob_len);
+        config_blob_transfer = CONFIG_BLOB_IDLE;
+        result.success = (rc == 0);
+        result.complete = true;
+        result.generation = zmk_runtime_sensor_rotate_get_global_generation();
+    }
+
+    resp->which_response_type = cormoran_rsr_Response_import_config_tag;
+    resp->response_type.import_config = result;
+    return rc;
+}
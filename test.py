@@ -1,6 +1,10 @@
+import json
+import os
 import platform
+import re
 import shutil
 import subprocess
+import tempfile
 import unittest
 from pathlib import Path
 
@@ -16,10 +20,215 @@ def run_west(args: list[str]) -> subprocess.CompletedProcess[str]:
         cwd=THIS_DIR,
     )
 
+def collect_benchmark_results(tests_build: Path) -> list[dict]:
+    """Parse the "rsr_bench:" JSON lines printed by tests/bench from its logs."""
+    results = {}
+    for log in tests_build.rglob("*.log"):
+        if "bench" not in log.parts:
+            continue
+        for line in log.read_text(errors="replace").splitlines():
+            _, sep, payload = line.partition("rsr_bench: ")
+            if sep:
+                result = json.loads(payload)
+                results[result["scenario"]] = result
+    return list(results.values())
+
+def format_table(columns: list[str], rows: list[list]) -> str:
+    rows = [columns] + [[str(v) for v in row] for row in rows]
+    widths = [max(len(row[i]) for row in rows) for i in range(len(columns))]
+    return "\n".join("  ".join(v.ljust(w) for v, w in zip(row, widths)) for row in rows)
+
+def format_benchmark_results(results: list[dict]) -> str:
+    columns = ["scenario", "cycles_mean", "cycles_p50", "cycles_p90", "cycles_p99",
+               "cycles_p999", "cycles_max"]
+    return format_table(columns, [[r[c] for c in columns] for r in results])
+
+FOOTPRINT_DIR = THIS_DIR / "tests" / "footprint"
+
+# Objects of this module in the linker map, besides those of src/
+FOOTPRINT_GENERATED_OBJECTS = {"custom.pb.c.obj"}
+
+def module_objects() -> set[str]:
+    return {f"{c.name}.obj" for c in (THIS_DIR / "src").rglob("*.c")} | FOOTPRINT_GENERATED_OBJECTS
+
+def footprint_artifacts() -> list[str]:
+    """Artifacts of tests/footprint/build.yaml, in order."""
+    text = (FOOTPRINT_DIR / "build.yaml").read_text()
+    return re.findall(r"^\s*-\s*artifact:\s*(\S+)", text, re.MULTILINE)
+
+def derive_footprint_budgets(results: dict[str, dict], margin_percent: float) -> dict[str, dict]:
+    """Budgets of measured configurations: their RAM and ROM plus margin_percent, rounded up."""
+    return {
+        artifact: {key: -(-r[key] * (100 + margin_percent) // 100) for key in ("ram", "rom")}
+        for artifact, r in results.items()
+    }
+
+def parse_linker_map(text: str, objects: set[str]) -> dict[str, dict[str, int]]:
+    """Sum the input sections of the given objects in a GNU ld map per symbol.
+
+    Zephyr builds with -ffunction-sections -fdata-sections, so each input section holds one
+    symbol, named after its section. Sections in a RAM region count as RAM, those in a flash
+    region as ROM, and initialized data as both as its initial values are stored in flash.
+    Returns {"<object>:<symbol>": {"ram": bytes, "rom": bytes}}.
+    """
+    regions = []
+    symbols: dict[str, dict[str, int]] = {}
+    in_memory_map = False
+    output_loaded = False
+    pending = None
+
+    for line in text.splitlines():
+        if line.startswith("Linker script and memory map"):
+            in_memory_map = True
+            continue
+        if not in_memory_map:
+            # Name Origin Length of the Memory Configuration
+            m = re.match(r"^(\S+)\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)", line)
+            if m and m.group(1) != "*default*":
+                kind = "ram" if "RAM" in m.group(1).upper() else "rom"
+                origin = int(m.group(2), 16)
+                regions.append((origin, origin + int(m.group(3), 16), kind))
+            continue
+
+        # Output sections start in the first column, initialized data has a load address
+        if line and not line[0].isspace():
+            output_loaded = "load address" in line
+            pending = None
+            continue
+
+        m = re.match(r"^ (\S+)\s*$", line)
+        if m:
+            pending = m.group(1)
+            continue
+        m = re.match(r"^ (\S+)?\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S.*)$", line)
+        section = (m.group(1) or pending) if m else None
+        pending = None
+        if not m or not section or section.startswith("*"):
+            continue
+
+        obj = re.search(r"([^/\\()]+\.obj)\)?$", m.group(4))
+        size = int(m.group(3), 16)
+        if not obj or obj.group(1) not in objects or size == 0:
+            continue
+
+        address = int(m.group(2), 16)
+        kind = next((k for start, end, k in regions if start <= address < end), None)
+        if kind is None:
+            continue
+        symbol = re.sub(r"^\.(text|rodata|data|bss|noinit)\.", "", section)
+        entry = symbols.setdefault(f"{obj.group(1)}:{symbol}", {"ram": 0, "rom": 0})
+        entry[kind] += size
+        if kind == "ram" and output_loaded:
+            entry["rom"] += size
+    return symbols
+
+def format_footprint_results(results: dict[str, dict], budgets: dict[str, dict],
+                             baseline: dict[str, dict], top: int = 10) -> str:
+    """Totals per configuration against their budget and a baseline, then the largest symbols."""
+    def delta(artifact, key):
+        base = baseline.get(artifact)
+        return f"{results[artifact][key] - base[key]:+d}" if base else ""
+
+    summary = format_table(
+        ["configuration", "ram", "ram_budget", "ram_delta", "rom", "rom_budget", "rom_delta"],
+        [[artifact, r["ram"], budgets.get(artifact, {}).get("ram", "-"), delta(artifact, "ram"),
+          r["rom"], budgets.get(artifact, {}).get("rom", "-"), delta(artifact, "rom")]
+         for artifact, r in results.items()],
+    )
+    sections = [summary]
+    for artifact, r in results.items():
+        largest = sorted(r["symbols"].items(), key=lambda s: -(s[1]["ram"] + s[1]["rom"]))
+        sections.append(f"{artifact}:\n" + format_table(
+            ["symbol", "ram", "rom"],
+            [[name, s["ram"], s["rom"]] for name, s in largest[:top]],
+        ))
+    return "\n\n".join(sections)
+
 @dataclass
 class NotFound:
     text: str
 
+class HostTests(unittest.TestCase):
+    """Tests of the Zephyr-free parts of the behavior, built with the host compiler."""
+
+    @unittest.skipUnless(shutil.which("cc"), "a host C compiler is required")
+    def test_accumulator(self):
+        tmp = tempfile.TemporaryDirectory()
+        self.addCleanup(tmp.cleanup)
+        binary = Path(tmp.name) / "accumulator_test"
+        result = subprocess.run(
+            ["cc", "-std=c11", "-Wall", "-Werror", "-I", str(THIS_DIR / "src" / "behaviors"),
+             "-o", str(binary), str(THIS_DIR / "tests" / "host" / "accumulator_test.c")],
+            capture_output=True,
+            text=True,
+        )
+        self.assertEqual(result.returncode, 0, result.stdout + result.stderr)
+
+        result = subprocess.run([str(binary)], capture_output=True, text=True)
+        self.assertEqual(result.returncode, 0, result.stdout + result.stderr)
+        self.assertIn("PASS: accumulator", result.stdout)
+
+class FootprintMapTests(unittest.TestCase):
+    """Tests of the linker map parsing of the footprint test, on a map excerpt."""
+
+    MAP = """\
+Memory Configuration
+
+Name             Origin             Length             Attributes
+FLASH            0x0000000000027000 0x00000000000c5000 xr
+RAM              0x0000000020000000 0x0000000000040000 xw
+*default*        0x0000000000000000 0xffffffffffffffff
+
+Linker script and memory map
+
+text            0x0000000000027000     0x9000
+ .text.zmk_runtime_sensor_rotate_apply_updates
+                0x0000000000027100      0x1a4 app/libapp.a(behavior_runtime_sensor_rotate.c.obj)
+                0x0000000000027100                zmk_runtime_sensor_rotate_apply_updates
+ .text.other    0x0000000000027300       0x40 zephyr/libzephyr.a(other.c.obj)
+ .rodata.default_behaviors
+                0x0000000000028000       0x80 app/libapp.a(behavior_runtime_sensor_rotate.c.obj)
+ .text.encode_sensors
+                0x0000000000028100       0x60 app/libapp.a(custom_handler.c.obj)
+ *fill*         0x0000000000028160        0x4 
+
+datas           0x0000000020000000       0x10 load address 0x0000000000030000
+ .data.rsr_state
+                0x0000000020000000        0x8 app/libapp.a(behavior_runtime_sensor_rotate.c.obj)
+
+bss             0x0000000020000100     0x2000
+ .bss.global_data
+                0x0000000020000100     0x1978 app/libapp.a(behavior_runtime_sensor_rotate.c.obj)
+ .bss.cormoran_rsr_Response_msg
+                0x0000000020001a78       0x20 modules/rsr/libmodules__rsr.a(custom.pb.c.obj)
+ .bss.unrelated 0x0000000020001a98       0x10 app/libapp.a(keymap.c.obj)
+"""
+
+    def test_footprint_artifacts(self):
+        artifacts = footprint_artifacts()
+
+        self.assertEqual(len(artifacts), 10)
+        self.assertEqual(artifacts[0], "rsr_footprint_s1_l4_norpc")
+        self.assertIn("rsr_footprint_s4_l32_cap_s1_l4_rpc", artifacts)
+
+    def test_derive_footprint_budgets(self):
+        budgets = derive_footprint_budgets({"a": {"ram": 1000, "rom": 1001, "symbols": {}}}, 2)
+
+        self.assertEqual(budgets, {"a": {"ram": 1020, "rom": 1022}})
+
+    def test_parse_linker_map(self):
+        symbols = parse_linker_map(self.MAP, module_objects())
+
+        self.assertEqual(symbols, {
+            "behavior_runtime_sensor_rotate.c.obj:zmk_runtime_sensor_rotate_apply_updates":
+                {"ram": 0, "rom": 0x1a4},
+            "behavior_runtime_sensor_rotate.c.obj:default_behaviors": {"ram": 0, "rom": 0x80},
+            "custom_handler.c.obj:encode_sensors": {"ram": 0, "rom": 0x60},
+            "behavior_runtime_sensor_rotate.c.obj:rsr_state": {"ram": 0x8, "rom": 0x8},
+            "behavior_runtime_sensor_rotate.c.obj:global_data": {"ram": 0x1978, "rom": 0},
+            "custom.pb.c.obj:cormoran_rsr_Response_msg": {"ram": 0x20, "rom": 0},
+        })
+
 class WestCommandsTests(unittest.TestCase):
     WEST_TOPDIR: Path
     BUILD_DIR: Path
@@ -41,6 +250,33 @@ class WestCommandsTests(unittest.TestCase):
         result = run_west(["zmk-test", "tests", '-m', '.'])
         self.assertEqual(result.returncode, 0, result.stdout + result.stderr)
         self.assertIn("PASS: studio", result.stdout)
+        self.assertIn("PASS: profiles", result.stdout)
+        self.assertIn("PASS: bench", result.stdout)
+        self.assertIn("PASS: stress", result.stdout)
+        self.assertIn("PASS: overrides", result.stdout)
+        self.assertIn("PASS: split", result.stdout)
+
+        results = collect_benchmark_results(tests_build)
+        self.assertEqual(len(results), 7, "benchmark results are missing")
+        results_path = self.BUILD_DIR / "rsr-benchmark.json"
+        results_path.write_text(json.dumps(results, indent=2))
+        print(format_benchmark_results(results))
+
+        # Compare against results of a previous run, e.g. from the base branch in CI
+        baseline_path = os.environ.get("RSR_BENCH_BASELINE")
+        if baseline_path:
+            tolerance = float(os.environ.get("RSR_BENCH_TOLERANCE", "0.2"))
+            baseline = {r["scenario"]: r for r in json.loads(Path(baseline_path).read_text())}
+            for r in results:
+                base = baseline.get(r["scenario"])
+                if base is None:
+                    continue
+                for key in ("cycles_p50", "cycles_p99"):
+                    limit = base[key] * (1 + tolerance)
+                    self.assertLessEqual(
+                        r[key], max(limit, base[key] + 1),
+                        f"{r['scenario']} {key} regressed: {base[key]} -> {r[key]}",
+                    )
 
     def test_zmk_build(self):
         artifacts_and_expected_config: dict[str, list[str | NotFound]] = {
@@ -49,13 +285,31 @@ class WestCommandsTests(unittest.TestCase):
                 "CONFIG_ZMK_STUDIO=y",
                 "CONFIG_ZMK_RUNTIME_SENSOR_ROTATE=y",
                 "CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_STUDIO_RPC=y",
+                "CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_SETTINGS_PER_SENSOR=y",
             ],
             "my_awesome_keyboard_without_custom_rpc_support": [
                 "CONFIG_MY_AWESOME_KEYBOARD_SPECIAL_FEATURE=y",
                 "# CONFIG_ZMK_STUDIO is not set",
                 "CONFIG_ZMK_RUNTIME_SENSOR_ROTATE=y",
                 NotFound("CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_STUDIO_RPC"),
-            ]
+            ],
+            "my_awesome_split_left": [
+                "CONFIG_ZMK_SPLIT=y",
+                "CONFIG_ZMK_SPLIT_ROLE_CENTRAL=y",
+                "CONFIG_ZMK_RUNTIME_SENSOR_ROTATE=y",
+            ],
+            "my_awesome_split_right": [
+                "CONFIG_ZMK_SPLIT=y",
+                NotFound("CONFIG_ZMK_SPLIT_ROLE_CENTRAL=y"),
+                "CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_SPLIT_AGGREGATE=y",
+            ],
+        }
+        # The peripheral links the aggregation only, the behavior runs on the central
+        artifacts_and_expected_objects: dict[str, list[str | NotFound]] = {
+            "my_awesome_split_right": [
+                "runtime_sensor_rotate_aggregate.c.obj",
+                NotFound("behavior_runtime_sensor_rotate.c.obj"),
+            ],
         }
 
         for artifact in artifacts_and_expected_config.keys():
@@ -77,5 +331,88 @@ class WestCommandsTests(unittest.TestCase):
                         self.fail(f"{entry} not found in {config_path} for {artifact}")
             self.assertTrue((config_path.parent / "zmk.uf2").exists(), f"{artifact} zmk.uf2 is missing in {config_path.parent}")
 
+        for artifact, entries in artifacts_and_expected_objects.items():
+            map_path = self.BUILD_DIR / artifact / "zephyr" / "zephyr.map"
+            self.assertTrue(map_path.exists(), f"{artifact} zephyr.map is missing")
+            map_text = map_path.read_text(errors="replace")
+            for entry in entries:
+                if isinstance(entry, NotFound):
+                    if entry.text in map_text:
+                        self.fail(f"{entry.text} found in {map_path} for {artifact}, but it should not be linked")
+                elif entry not in map_text:
+                    self.fail(f"{entry} not found in {map_path} for {artifact}")
+
+    def test_footprint(self):
+        """Build tests/footprint and check the RAM and ROM of this module against budgets.
+
+        With RSR_FOOTPRINT_UPDATE=1, the budgets and the baseline in tests/footprint are
+        rewritten from this build instead, to be committed.
+        """
+        build_dir = self.BUILD_DIR
+        budgets_path = Path(os.environ.get("RSR_FOOTPRINT_BUDGETS",
+                                           FOOTPRINT_DIR / "budgets.json"))
+        budgets_file = json.loads(budgets_path.read_text())
+        budgets = budgets_file["configurations"]
+        update = os.environ.get("RSR_FOOTPRINT_UPDATE") == "1"
+
+        artifacts = footprint_artifacts()
+        for artifact in artifacts:
+            shutil.rmtree(build_dir / artifact, ignore_errors=True)
+        result = run_west(["zmk-build", "tests/footprint/config", "-m", "tests/footprint", ".",
+                           "-q"])
+        self.assertEqual(result.returncode, 0, result.stdout + result.stderr)
+
+        objects = module_objects()
+        results = {}
+        for artifact in artifacts:
+            map_path = build_dir / artifact / "zephyr" / "zephyr.map"
+            self.assertTrue(map_path.exists(), f"{artifact} zephyr.map is missing")
+            symbols = parse_linker_map(map_path.read_text(errors="replace"), objects)
+            self.assertTrue(symbols, f"no symbols of this module found in {map_path}")
+            results[artifact] = {
+                "ram": sum(s["ram"] for s in symbols.values()),
+                "rom": sum(s["rom"] for s in symbols.values()),
+                "symbols": symbols,
+            }
+        derived = derive_footprint_budgets(results, budgets_file["margin_percent"])
+        totals = {artifact: {"ram": r["ram"], "rom": r["rom"]} for artifact, r in results.items()}
+
+        # Compare against the committed baseline, or results of another run, e.g. from the base
+        # branch in CI
+        baseline_path = Path(os.environ.get("RSR_FOOTPRINT_BASELINE",
+                                            FOOTPRINT_DIR / "baseline.json"))
+        baseline = json.loads(baseline_path.read_text()) if baseline_path.exists() else {}
+
+        table = format_footprint_results(results, derived if update else budgets, baseline)
+        (build_dir / "rsr-footprint.json").write_text(json.dumps(results, indent=2))
+        (build_dir / "rsr-footprint.txt").write_text(table + "\n")
+        (build_dir / "rsr-footprint-budgets.json").write_text(json.dumps(
+            {"margin_percent": budgets_file["margin_percent"], "configurations": derived},
+            indent=2) + "\n")
+        print(table)
+
+        if update:
+            budgets_file["configurations"] = derived
+            budgets_path.write_text(json.dumps(budgets_file, indent=2) + "\n")
+            (FOOTPRINT_DIR / "baseline.json").write_text(json.dumps(totals, indent=2) + "\n")
+            (FOOTPRINT_DIR / "baseline.txt").write_text(table + "\n")
+            return
+
+        for artifact, r in results.items():
+            if artifact not in budgets:
+                continue
+            for key in ("ram", "rom"):
+                self.assertLessEqual(
+                    r[key], budgets[artifact][key],
+                    f"{artifact} {key} exceeds its budget in {budgets_path}",
+                )
+
+        # Budgets are recorded from a build on the zmk-build-arm image, a configuration without
+        # one is reported instead of failing until they are committed
+        missing = [artifact for artifact in results if artifact not in budgets]
+        if missing:
+            self.skipTest(f"no budget in {budgets_path} for {', '.join(missing)}, record them "
+                          "with RSR_FOOTPRINT_UPDATE=1 on the zmk-build-arm image")
+
 if __name__ == "__main__":
     unittest.main()
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Host test of the fixed-point rotation accumulator, run by test.py. Checks that it matches the
+// sensor_value math it replaced wherever that math was exact, and that it keeps the fractions the
+// old math dropped.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "runtime_sensor_rotate_accumulator.h"
+
+#define CHECK(cond, ...)                                                                           \
+    do {                                                                                           \
+        if (!(cond)) {                                                                             \
+            fprintf(stderr, "%s:%d: ", __FILE__, __LINE__);                                        \
+            fprintf(stderr, __VA_ARGS__);                                                          \
+            fprintf(stderr, "\n");                                                                 \
+            exit(1);                                                                               \
+        }                                                                                          \
+    } while (0)
+
+struct sensor_value {
+    int32_t val1;
+    int32_t val2;
+};
+
+// Previous behavior_runtime_sensor_rotate_accept_data math, same as behavior_sensor_rotate_common
+static int legacy_triggers(struct sensor_value *remainder, struct sensor_value value,
+                           int triggers_per_rotation) {
+    remainder->val1 += value.val1;
+    remainder->val2 += value.val2;
+
+    if (remainder->val2 >= 1000000 || remainder->val2 <= -1000000) {
+        remainder->val1 += remainder->val2 / 1000000;
+        remainder->val2 %= 1000000;
+    }
+
+    int trigger_degrees = 360 / triggers_per_rotation;
+    int triggers = remainder->val1 / trigger_degrees;
+    remainder->val1 %= trigger_degrees;
+    return triggers;
+}
+
+static uint32_t random_state = 1;
+
+static uint32_t test_random(void) {
+    random_state = random_state * 1664525 + 1013904223;
+    return random_state >> 8;
+}
+
+// Whole degree events with a count that divides 360, where the old math was exact
+static void test_matches_legacy_math(void) {
+    for (int tpr = 1; tpr <= 360; tpr++) {
+        if (360 % tpr != 0) {
+            continue;
+        }
+        struct sensor_value remainder = {0};
+        int64_t acc = 0;
+        int64_t scale = rsr_accumulator_scale(tpr, 100);
+
+        for (int i = 0; i < 20000; i++) {
+            // Mostly small steps, sometimes large jumps, both directions
+            int32_t degrees = (test_random() % 8 == 0) ? (int32_t)(test_random() % 2000) - 1000
+                                                       : (int32_t)(test_random() % 61) - 30;
+            int expected = legacy_triggers(&remainder, (struct sensor_value){.val1 = degrees}, tpr);
+            int actual = rsr_accumulator_add(&acc, degrees, 0, scale);
+            CHECK(actual == expected, "tpr=%d event %d: %d triggers, expected %d", tpr, i, actual,
+                  expected);
+            CHECK(acc == (int64_t)remainder.val1 * RSR_ACCUMULATOR_MICRO_DEGREES * scale,
+                  "tpr=%d event %d: remainder diverged", tpr, i);
+        }
+    }
+}
+
+// Counts that don't divide 360 lose no rotation, e.g. 7 triggers per rotation
+static void test_fractional_degrees_per_trigger(void) {
+    const int counts[] = {7, 11, 48, 500, 1000};
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        int tpr = counts[c];
+        int64_t scale = rsr_accumulator_scale(tpr, 100);
+        int64_t acc = 0;
+        int total = 0;
+
+        // Ten rotations in 1 degree steps
+        for (int i = 0; i < 3600; i++) {
+            total += rsr_accumulator_add(&acc, 1, 0, scale);
+        }
+        CHECK(total == 10 * tpr, "tpr=%d: %d triggers for 10 rotations", tpr, total);
+        CHECK(acc == 0, "tpr=%d: remainder left after whole rotations", tpr);
+
+        // And back in 0.25 degree steps
+        for (int i = 0; i < 14400; i++) {
+            total += rsr_accumulator_add(&acc, 0, -250000, scale);
+        }
+        CHECK(total == 0, "tpr=%d: %d triggers after rotating back", tpr, total);
+    }
+}
+
+// Resolution scales the trigger count without losing the remainder
+static void test_resolution(void) {
+    int64_t acc = 0;
+    int total = 0;
+    int64_t scale = rsr_accumulator_scale(20, 150);
+
+    // One rotation at 150% of 20 triggers per rotation
+    for (int i = 0; i < 360; i++) {
+        total += rsr_accumulator_add(&acc, 1, 0, scale);
+    }
+    CHECK(total == 30, "%d triggers at 150%%", total);
+
+    scale = rsr_accumulator_scale(20, 33);
+    total = 0;
+    for (int i = 0; i < 3 * 360; i++) {
+        total += rsr_accumulator_add(&acc, 1, 0, scale);
+    }
+    CHECK(total == 19, "%d triggers for 3 rotations at 33%%", total);
+}
+
+// The reciprocal estimate is corrected for large events too
+static void test_large_events(void) {
+    int64_t scale = rsr_accumulator_scale(360, 1000);
+    for (int32_t degrees = -100000; degrees <= 100000; degrees += 997) {
+        int64_t acc = 0;
+        int triggers = rsr_accumulator_add(&acc, degrees, 0, scale);
+        CHECK(triggers == degrees * 10, "%d degrees: %d triggers", degrees, triggers);
+        CHECK(acc == 0, "%d degrees: remainder left", degrees);
+    }
+}
+
+int main(void) {
+    test_matches_legacy_math();
+    test_fractional_degrees_per_trigger();
+    test_resolution();
+    test_large_events();
+    printf("PASS: accumulator\n");
+    return 0;
+}
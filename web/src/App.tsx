@@ -51,7 +51,7 @@ function App() {
               </button>
             </section>
 
-            <RuntimeSensorRotateConfig />
+            <RuntimeSensorRotateConfig deviceKey={deviceName} />
           </>
         )}
       />
@@ -3,7 +3,14 @@
  * Provides UI for configuring sensor rotation bindings per layer
  */
 
-import { useContext, useState, useEffect, useCallback, useMemo } from "react";
+import {
+  useContext,
+  useState,
+  useEffect,
+  useCallback,
+  useMemo,
+  useRef,
+} from "react";
 import {
   ZMKAppContext,
   ZMKCustomSubsystem,
@@ -11,24 +18,56 @@ import {
 import {
   Request,
   Response,
+  Acceleration,
   Binding,
+  Direction,
   LayerBindings,
+  RotationEvent,
+  SensorBindings,
   SensorInfo,
 } from "./proto/cormoran/rsr/custom";
-import { call_rpc } from "@zmkfirmware/zmk-studio-ts-client";
 import type { GetBehaviorDetailsResponse } from "@zmkfirmware/zmk-studio-ts-client/behaviors";
+import { loadBehaviors, readCachedBehaviors } from "./behaviorCache";
 
 export const SUBSYSTEM_IDENTIFIER = "cormoran_rsr";
 
-export function RuntimeSensorRotateConfig() {
+// DRAIN_EVENTS_MAX of the firmware, a full page means more are waiting
+const DRAIN_PAGE_SIZE = 16;
+const LIVE_POLL_MS = 200;
+const MAX_LIVE_EVENTS = 500;
+const PLOT_WINDOW_MS = 5000;
+// max_size of the data of ExportConfigResponse and ImportConfigRequest
+const CONFIG_CHUNK_SIZE = 128;
+
+interface RuntimeSensorRotateConfigProps {
+  // Identifies the device in the behavior details cache
+  deviceKey?: string;
+}
+
+export function RuntimeSensorRotateConfig({
+  deviceKey = "default",
+}: RuntimeSensorRotateConfigProps) {
   const zmkApp = useContext(ZMKAppContext);
   const [sensors, setSensors] = useState<SensorInfo[]>([]);
   const [sensorIndex, setSensorIndex] = useState<number>(0);
+  const [channel, setChannel] = useState<number>(0);
   const [selectedLayer, setSelectedLayer] = useState<number>(0);
-  const [allLayerBindings, setAllLayerBindings] = useState<LayerBindings[]>([]);
+  const [allBindings, setAllBindings] = useState<SensorBindings[]>([]);
+  // Generation of allBindings, lets the firmware skip resending unchanged bindings
+  const generation = useRef<number | undefined>(undefined);
   const [behaviors, setBehaviors] = useState<GetBehaviorDetailsResponse[]>([]);
   const [isLoading, setIsLoading] = useState(false);
   const [error, setError] = useState<string | null>(null);
+  const [hasUnsavedChanges, setHasUnsavedChanges] = useState(false);
+  const [isLive, setIsLive] = useState(false);
+  const [liveEvents, setLiveEvents] = useState<RotationEvent[]>([]);
+  const [droppedEvents, setDroppedEvents] = useState(0);
+  const [eventLogEnabled, setEventLogEnabled] = useState(true);
+  const [profileCount, setProfileCount] = useState(1);
+  const [activeProfile, setActiveProfile] = useState(0);
+  // Bumped after an import to reload everything read from the device
+  const [reloadCount, setReloadCount] = useState(0);
+  const importInput = useRef<HTMLInputElement>(null);
 
   // eslint-disable-next-line react-hooks/exhaustive-deps
   const subsystem = useMemo(
@@ -67,51 +106,87 @@ export function RuntimeSensorRotateConfig() {
     };
 
     loadSensors();
-  }, [zmkApp?.state.connection, subsystem]);
+  }, [zmkApp?.state.connection, subsystem, reloadCount]);
 
-  // Load available behaviors from ZMK Studio
+  // Load the binding profiles, firmware without them reports none
   useEffect(() => {
-    const loadBehaviors = async () => {
-      if (!zmkApp?.state.connection) return;
-      setIsLoading(true);
-      setError(null);
+    const loadProfiles = async () => {
+      if (!zmkApp?.state.connection || !subsystem) return;
+      try {
+        const service = new ZMKCustomSubsystem(
+          zmkApp.state.connection,
+          subsystem.index
+        );
 
-      const conn = zmkApp.state.connection;
+        const request = Request.create({
+          getProfiles: {},
+        });
 
-      const res = await call_rpc(conn, {
-        behaviors: {
-          listAllBehaviors: true,
-        },
-      });
-      if (res && res.meta) {
-        setIsLoading(false);
-        setError(`Error: ${res.meta}`);
-        return;
+        const payload = Request.encode(request).finish();
+        const responsePayload = await service.callRPC(payload);
+
+        if (responsePayload) {
+          const resp = Response.decode(responsePayload);
+
+          if (resp.getProfiles) {
+            setProfileCount(Math.max(resp.getProfiles.count, 1));
+            setActiveProfile(resp.getProfiles.active);
+          }
+        }
+      } catch (err) {
+        console.error("Failed to load profiles:", err);
       }
-      const behaviorIds = res?.behaviors?.listAllBehaviors?.behaviors ?? [];
-      const behaviors = await Promise.all(
-        behaviorIds.map(async (b) => {
-          const detailRes = await call_rpc(conn, {
-            behaviors: {
-              getBehaviorDetails: {
-                behaviorId: b,
-              },
-            },
-          });
-          return detailRes?.behaviors?.getBehaviorDetails;
-        })
-      );
-      setBehaviors(behaviors.filter((b) => b !== undefined));
-      setIsLoading(false);
     };
 
-    loadBehaviors();
-  }, [zmkApp?.state.connection]);
+    loadProfiles();
+  }, [zmkApp?.state.connection, subsystem, reloadCount]);
+
+  // Load available behaviors from ZMK Studio. Details cached by an earlier
+  // session are shown right away and replaced if the device has changed.
+  useEffect(() => {
+    if (!zmkApp?.state.connection) return;
+    const conn = zmkApp.state.connection;
+    let cancelled = false;
+
+    const cached = readCachedBehaviors(deviceKey);
+    if (cached) {
+      setBehaviors(cached);
+    } else {
+      setIsLoading(true);
+    }
+    setError(null);
+
+    loadBehaviors(conn, deviceKey)
+      .then((loaded) => {
+        if (!cancelled) setBehaviors(loaded);
+      })
+      .catch((err) => {
+        console.error("Failed to load behaviors:", err);
+        if (!cancelled) {
+          setError(err instanceof Error ? err.message : "Unknown error");
+        }
+      })
+      .finally(() => {
+        if (!cancelled) setIsLoading(false);
+      });
+
+    return () => {
+      cancelled = true;
+    };
+  }, [zmkApp?.state.connection, deviceKey]);
+
+  const allLayerBindings = useMemo(
+    () =>
+      allBindings.find(
+        (sensor) =>
+          sensor.sensorIndex === sensorIndex && sensor.channel === channel
+      )?.layers ?? [],
+    [allBindings, sensorIndex, channel]
+  );
 
-  // Load all layer bindings for the selected sensor
+  // Load the bindings of all sensors and layers in a single request
   const loadAllLayerBindings = useCallback(async () => {
     if (!zmkApp || !zmkApp.state.connection || !subsystem) return;
-    console.log("Loading layer bindings for sensor index:", sensorIndex);
 
     setIsLoading(true);
     setError(null);
@@ -123,9 +198,7 @@ export function RuntimeSensorRotateConfig() {
       );
 
       const request = Request.create({
-        getAllLayerBindings: {
-          sensorIndex: sensorIndex,
-        },
+        getAllBindings: { ifChangedSince: generation.current },
       });
 
       const payload = Request.encode(request).finish();
@@ -133,9 +206,11 @@ export function RuntimeSensorRotateConfig() {
 
       if (responsePayload) {
         const resp = Response.decode(responsePayload);
-        console.log("Received layer bindings response:", resp);
-        if (resp.getAllLayerBindings) {
-          setAllLayerBindings(resp.getAllLayerBindings.bindings || []);
+        if (resp.getAllBindings?.notModified) {
+          // Cached bindings are up to date
+        } else if (resp.getAllBindings) {
+          setAllBindings(resp.getAllBindings.sensors || []);
+          generation.current = resp.getAllBindings.generation;
         } else if (resp.error) {
           setError(`Error: ${resp.error.message}`);
         }
@@ -148,10 +223,39 @@ export function RuntimeSensorRotateConfig() {
     } finally {
       setIsLoading(false);
     }
-  }, [zmkApp, subsystem, sensorIndex]);
+  }, [zmkApp, subsystem]);
+
+  // Edits are persisted by the firmware after a debounce; poll whether any
+  // are still pending so the user can flush or drop them explicitly.
+  const checkUnsavedChanges = useCallback(async () => {
+    if (!zmkApp || !zmkApp.state.connection || !subsystem) return;
+
+    try {
+      const service = new ZMKCustomSubsystem(
+        zmkApp.state.connection,
+        subsystem.index
+      );
+
+      const request = Request.create({
+        checkUnsavedChanges: {},
+      });
+
+      const payload = Request.encode(request).finish();
+      const responsePayload = await service.callRPC(payload);
+
+      if (responsePayload) {
+        const resp = Response.decode(responsePayload);
+        if (resp.checkUnsavedChanges) {
+          setHasUnsavedChanges(resp.checkUnsavedChanges.unsavedChanges);
+        }
+      }
+    } catch (err) {
+      console.error("Failed to check unsaved changes:", err);
+    }
+  }, [zmkApp?.state.connection, subsystem]);
 
-  const saveLayerCwBindings = useCallback(
-    async (layer: number, cwBinding: Binding, reload: boolean) => {
+  const saveOrDiscardChanges = useCallback(
+    async (discard: boolean) => {
       if (!zmkApp || !zmkApp.state.connection || !subsystem) return;
 
       setIsLoading(true);
@@ -163,23 +267,24 @@ export function RuntimeSensorRotateConfig() {
           subsystem.index
         );
 
-        const request = Request.create({
-          setLayerCwBinding: {
-            sensorIndex: sensorIndex,
-            layer: layer,
-            binding: cwBinding,
-          },
-        });
+        const request = Request.create(
+          discard ? { discardChanges: {} } : { saveChanges: {} }
+        );
 
         const payload = Request.encode(request).finish();
         const responsePayload = await service.callRPC(payload);
 
         if (responsePayload) {
           const resp = Response.decode(responsePayload);
+          const success = discard
+            ? resp.discardChanges?.success
+            : resp.saveChanges?.success;
 
-          if (resp.setLayerCwBinding?.success) {
-            // Reload bindings to show updated values
-            if (reload) {
+          if (success) {
+            setHasUnsavedChanges(false);
+            if (discard) {
+              // Reloads the sensors, whose resolution and latency are reverted too
+              setReloadCount((count) => count + 1);
               await loadAllLayerBindings();
             }
           } else if (resp.error) {
@@ -187,19 +292,29 @@ export function RuntimeSensorRotateConfig() {
           }
         }
       } catch (err) {
-        console.error("Failed to save layer bindings:", err);
+        console.error("Failed to save or discard changes:", err);
         setError(
-          `Failed to save: ${err instanceof Error ? err.message : "Unknown error"}`
+          `Failed: ${err instanceof Error ? err.message : "Unknown error"}`
         );
       } finally {
         setIsLoading(false);
       }
     },
-    [zmkApp?.state.connection, subsystem, sensorIndex, loadAllLayerBindings]
+    [zmkApp?.state.connection, subsystem, loadAllLayerBindings]
   );
 
-  const saveLayerCcwBindings = useCallback(
-    async (layer: number, ccwBinding: Binding, reload: boolean) => {
+  useEffect(() => {
+    checkUnsavedChanges();
+  }, [checkUnsavedChanges]);
+
+  // Save bindings and acceleration of a layer in a single request
+  const saveLayerBindings = useCallback(
+    async (
+      layer: number,
+      cwBinding: Binding,
+      ccwBinding: Binding,
+      acceleration: Acceleration
+    ) => {
       if (!zmkApp || !zmkApp.state.connection || !subsystem) return;
 
       setIsLoading(true);
@@ -212,10 +327,26 @@ export function RuntimeSensorRotateConfig() {
         );
 
         const request = Request.create({
-          setLayerCcwBinding: {
-            sensorIndex: sensorIndex,
-            layer: layer,
-            binding: ccwBinding,
+          setBindings: {
+            updates: [
+              {
+                sensorIndex,
+                channel,
+                layer,
+                direction: Direction.DIRECTION_CW,
+                binding: cwBinding,
+              },
+              {
+                sensorIndex,
+                channel,
+                layer,
+                direction: Direction.DIRECTION_CCW,
+                binding: ccwBinding,
+              },
+            ],
+            accelerationUpdates: [
+              { sensorIndex, channel, layer, acceleration },
+            ],
           },
         });
 
@@ -225,9 +356,35 @@ export function RuntimeSensorRotateConfig() {
         if (responsePayload) {
           const resp = Response.decode(responsePayload);
 
-          if (resp.setLayerCcwBinding?.success) {
-            // Reload bindings to show updated values
-            if (reload) {
+          if (resp.setBindings?.success) {
+            if (
+              generation.current !== undefined &&
+              resp.setBindings.generation === (generation.current + 1) >>> 0
+            ) {
+              // Nothing else changed since the last load, no need to reload
+              generation.current = resp.setBindings.generation;
+              setAllBindings((prev) =>
+                prev.map((sensor) =>
+                  sensor.sensorIndex !== sensorIndex ||
+                  sensor.channel !== channel
+                    ? sensor
+                    : {
+                        ...sensor,
+                        layers: sensor.layers.map((l) =>
+                          l.layer !== layer
+                            ? l
+                            : {
+                                ...l,
+                                cwBinding,
+                                ccwBinding,
+                                acceleration,
+                              }
+                        ),
+                      }
+                )
+              );
+            } else {
+              // Reload bindings to show updated values
               await loadAllLayerBindings();
             }
           } else if (resp.error) {
@@ -242,19 +399,301 @@ export function RuntimeSensorRotateConfig() {
       } finally {
         setIsLoading(false);
       }
+      await checkUnsavedChanges();
     },
-    [zmkApp?.state.connection, subsystem, sensorIndex, loadAllLayerBindings]
+    [
+      zmkApp?.state.connection,
+      subsystem,
+      sensorIndex,
+      channel,
+      loadAllLayerBindings,
+      checkUnsavedChanges,
+    ]
   );
 
-  // Save bindings for a specific layer
-  const saveLayerBindings = useCallback(
-    async (layer: number, cwBinding: Binding, ccwBinding: Binding) => {
-      await saveLayerCwBindings(layer, cwBinding, false);
-      await saveLayerCcwBindings(layer, ccwBinding, true);
+  // Per-sensor settings are saved along with the bindings, after the debounce
+  // period of the firmware or on SaveChanges
+  const setSensorSetting = useCallback(
+    async (
+      request: Partial<Request>,
+      succeeded: (resp: Response) => boolean | undefined,
+      update: Partial<SensorInfo>
+    ) => {
+      if (!zmkApp?.state.connection || !subsystem) return;
+
+      setError(null);
+      try {
+        const service = new ZMKCustomSubsystem(
+          zmkApp.state.connection,
+          subsystem.index
+        );
+
+        const payload = Request.encode(Request.create(request)).finish();
+        const responsePayload = await service.callRPC(payload);
+
+        if (responsePayload) {
+          const resp = Response.decode(responsePayload);
+          if (succeeded(resp)) {
+            setSensors((prev) =>
+              prev.map((sensor) =>
+                sensor.index === sensorIndex ? { ...sensor, ...update } : sensor
+              )
+            );
+          } else if (resp.error) {
+            setError(`Error: ${resp.error.message}`);
+          } else {
+            setError("Failed to update sensor");
+          }
+        }
+      } catch (err) {
+        console.error("Failed to update sensor:", err);
+        setError(
+          `Failed to update sensor: ${err instanceof Error ? err.message : "Unknown error"}`
+        );
+      }
+      await checkUnsavedChanges();
+    },
+    [zmkApp?.state.connection, subsystem, sensorIndex, checkUnsavedChanges]
+  );
+
+  // Switching is instant on the device, the bindings shown are reloaded from
+  // the new profile
+  const switchProfile = useCallback(
+    async (profile: number) => {
+      if (!zmkApp?.state.connection || !subsystem) return;
+
+      setError(null);
+      try {
+        const service = new ZMKCustomSubsystem(
+          zmkApp.state.connection,
+          subsystem.index
+        );
+
+        const request = Request.create({
+          setActiveProfile: { profile },
+        });
+
+        const payload = Request.encode(request).finish();
+        const responsePayload = await service.callRPC(payload);
+
+        if (responsePayload) {
+          const resp = Response.decode(responsePayload);
+          if (resp.setActiveProfile?.success) {
+            setActiveProfile(resp.setActiveProfile.active);
+            if (allBindings.length > 0) {
+              await loadAllLayerBindings();
+            }
+          } else if (resp.error) {
+            setError(`Error: ${resp.error.message}`);
+          } else {
+            setError("Failed to switch profile");
+          }
+        }
+      } catch (err) {
+        console.error("Failed to switch profile:", err);
+        setError(
+          `Failed to switch profile: ${err instanceof Error ? err.message : "Unknown error"}`
+        );
+      }
     },
-    [saveLayerCwBindings, saveLayerCcwBindings]
+    [zmkApp?.state.connection, subsystem, allBindings, loadAllLayerBindings]
   );
 
+  // Read the configuration blob in chunks and offer it as a file
+  const exportConfig = useCallback(async () => {
+    if (!zmkApp?.state.connection || !subsystem) return;
+
+    setIsLoading(true);
+    setError(null);
+    try {
+      const service = new ZMKCustomSubsystem(
+        zmkApp.state.connection,
+        subsystem.index
+      );
+
+      const chunks: Uint8Array[] = [];
+      let offset = 0;
+      let totalSize = 0;
+      do {
+        const request = Request.create({ exportConfig: { offset } });
+        const payload = Request.encode(request).finish();
+        const responsePayload = await service.callRPC(payload);
+        const resp = responsePayload && Response.decode(responsePayload);
+        if (!resp || !resp.exportConfig?.success) {
+          setError(
+            resp && resp.error
+              ? `Error: ${resp.error.message}`
+              : "Failed to export configuration"
+          );
+          return;
+        }
+        if (resp.exportConfig.data.length === 0) break;
+        chunks.push(resp.exportConfig.data);
+        offset += resp.exportConfig.data.length;
+        totalSize = resp.exportConfig.totalSize;
+      } while (offset < totalSize);
+
+      const url = URL.createObjectURL(
+        new Blob(chunks, { type: "application/octet-stream" })
+      );
+      const link = document.createElement("a");
+      link.href = url;
+      link.download = "runtime-sensor-rotate.rsr";
+      link.click();
+      URL.revokeObjectURL(url);
+    } catch (err) {
+      console.error("Failed to export configuration:", err);
+      setError(
+        `Failed to export: ${err instanceof Error ? err.message : "Unknown error"}`
+      );
+    } finally {
+      setIsLoading(false);
+    }
+  }, [zmkApp?.state.connection, subsystem]);
+
+  // Send a configuration blob in chunks. The device validates and applies it
+  // as a whole with the last one.
+  const importConfig = useCallback(
+    async (file: File) => {
+      if (!zmkApp?.state.connection || !subsystem) return;
+
+      setIsLoading(true);
+      setError(null);
+      try {
+        const service = new ZMKCustomSubsystem(
+          zmkApp.state.connection,
+          subsystem.index
+        );
+
+        const blob = new Uint8Array(await file.arrayBuffer());
+        let offset = 0;
+        do {
+          const data = blob.subarray(offset, offset + CONFIG_CHUNK_SIZE);
+          const request = Request.create({
+            importConfig: { offset, totalSize: blob.length, data },
+          });
+          const payload = Request.encode(request).finish();
+          const responsePayload = await service.callRPC(payload);
+          const resp = responsePayload && Response.decode(responsePayload);
+          if (!resp || !resp.importConfig?.success) {
+            setError(
+              resp && resp.error
+                ? `Error: ${resp.error.message}`
+                : "The configuration doesn't fit this firmware"
+            );
+            return;
+          }
+          offset += data.length;
+        } while (offset < blob.length);
+
+        generation.current = undefined;
+        setReloadCount((count) => count + 1);
+        await loadAllLayerBindings();
+        await checkUnsavedChanges();
+      } catch (err) {
+        console.error("Failed to import configuration:", err);
+        setError(
+          `Failed to import: ${err instanceof Error ? err.message : "Unknown error"}`
+        );
+      } finally {
+        setIsLoading(false);
+      }
+    },
+    [
+      zmkApp?.state.connection,
+      subsystem,
+      loadAllLayerBindings,
+      checkUnsavedChanges,
+    ]
+  );
+
+  const setSensorResolution = (resolutionPercent: number) =>
+    setSensorSetting(
+      { setSensorResolution: { sensorIndex, resolutionPercent } },
+      (resp) => resp.setSensorResolution?.success,
+      { resolutionPercent }
+    );
+
+  const setSensorMaxLatency = (maxLatencyMs: number) =>
+    setSensorSetting(
+      { setSensorMaxLatency: { sensorIndex, maxLatencyMs } },
+      (resp) => resp.setSensorMaxLatency?.success,
+      { maxLatencyMs }
+    );
+
+  // Drain the event log of the firmware while live. Recording on the device
+  // stops a few seconds after the last drain.
+  useEffect(() => {
+    if (!isLive || !zmkApp?.state.connection || !subsystem) return;
+
+    const service = new ZMKCustomSubsystem(
+      zmkApp.state.connection,
+      subsystem.index
+    );
+    // The first drain also returns what is left from earlier sessions
+    let sequence = 0;
+    let first = true;
+    let cancelled = false;
+    let timer: ReturnType<typeof setTimeout> | undefined;
+
+    const drain = async () => {
+      let delay = LIVE_POLL_MS;
+      try {
+        const request = Request.create({
+          drainEvents: { sinceSequence: sequence },
+        });
+
+        const payload = Request.encode(request).finish();
+        const responsePayload = await service.callRPC(payload);
+        if (cancelled) return;
+
+        if (responsePayload) {
+          const drained = Response.decode(responsePayload).drainEvents;
+          if (!drained?.enabled) {
+            setEventLogEnabled(false);
+            setIsLive(false);
+            return;
+          }
+          sequence = drained.nextSequence;
+          if (drained.dropped > 0 && !first) {
+            setDroppedEvents((prev) => prev + drained.dropped);
+          }
+          if (drained.events.length > 0) {
+            setLiveEvents((prev) =>
+              [...prev, ...drained.events].slice(-MAX_LIVE_EVENTS)
+            );
+          }
+          if (drained.events.length >= DRAIN_PAGE_SIZE) {
+            delay = 0;
+          }
+          first = false;
+        }
+      } catch (err) {
+        console.error("Failed to drain events:", err);
+        setIsLive(false);
+        return;
+      }
+      timer = setTimeout(drain, delay);
+    };
+
+    drain();
+    return () => {
+      cancelled = true;
+      clearTimeout(timer);
+    };
+  }, [isLive, zmkApp?.state.connection, subsystem]);
+
+  const sensorEvents = useMemo(
+    () =>
+      liveEvents.filter(
+        (event) =>
+          event.sensorIndex === sensorIndex && event.channel === channel
+      ),
+    [liveEvents, sensorIndex, channel]
+  );
+
+  const selectedSensor = sensors.find((sensor) => sensor.index === sensorIndex);
+
   if (!zmkApp) return null;
 
   if (!subsystem) {
@@ -277,12 +716,36 @@ export function RuntimeSensorRotateConfig() {
         Configure sensor rotation bindings per layer with persistent storage.
       </p>
 
+      {profileCount > 1 && (
+        <div className="input-group">
+          <label htmlFor="profile-select">Profile:</label>
+          <select
+            id="profile-select"
+            value={activeProfile}
+            disabled={isLoading}
+            onChange={(e) => switchProfile(parseInt(e.target.value))}
+          >
+            {Array.from({ length: profileCount }, (_, index) => (
+              <option key={index} value={index}>
+                Profile {index}
+              </option>
+            ))}
+          </select>
+          <span className="hint">
+            Bindings and acceleration below belong to the active profile.
+          </span>
+        </div>
+      )}
+
       <div className="input-group">
         <label htmlFor="sensor-select">Sensor:</label>
         <select
           id="sensor-select"
           value={sensorIndex}
-          onChange={(e) => setSensorIndex(parseInt(e.target.value))}
+          onChange={(e) => {
+            setSensorIndex(parseInt(e.target.value));
+            setChannel(0);
+          }}
         >
           {sensors.length > 0 ? (
             sensors.map((sensor) => (
@@ -299,6 +762,75 @@ export function RuntimeSensorRotateConfig() {
         </select>
       </div>
 
+      {selectedSensor && selectedSensor.channels > 1 && (
+        <div className="input-group">
+          <label htmlFor="channel-select">Channel:</label>
+          <select
+            id="channel-select"
+            value={channel}
+            onChange={(e) => setChannel(parseInt(e.target.value))}
+          >
+            {Array.from({ length: selectedSensor.channels }, (_, index) => (
+              <option key={index} value={index}>
+                Channel {index}
+              </option>
+            ))}
+          </select>
+        </div>
+      )}
+
+      {selectedSensor && (
+        <div className="input-group">
+          <label htmlFor="resolution-input">Resolution (%):</label>
+          <input
+            id="resolution-input"
+            key={selectedSensor.index}
+            type="number"
+            min="1"
+            max="1000"
+            defaultValue={selectedSensor.resolutionPercent || 100}
+            onBlur={(e) => {
+              const value = parseInt(e.target.value);
+              if (
+                value >= 1 &&
+                value <= 1000 &&
+                value !== (selectedSensor.resolutionPercent || 100)
+              ) {
+                setSensorResolution(value);
+              }
+            }}
+          />
+        </div>
+      )}
+
+      {selectedSensor && (
+        <div className="input-group">
+          <label htmlFor="max-latency-input">Max latency (ms):</label>
+          <input
+            id="max-latency-input"
+            key={selectedSensor.index}
+            type="number"
+            min="0"
+            max="65535"
+            defaultValue={selectedSensor.maxLatencyMs}
+            onBlur={(e) => {
+              const value = parseInt(e.target.value);
+              if (
+                value >= 0 &&
+                value <= 65535 &&
+                value !== selectedSensor.maxLatencyMs
+              ) {
+                setSensorMaxLatency(value);
+              }
+            }}
+          />
+          <span className="hint">
+            Shortens tap-ms of fast spins to finish within this time, 0 for no
+            bound.
+          </span>
+        </div>
+      )}
+
       <button
         className="btn btn-primary"
         disabled={isLoading}
@@ -307,6 +839,58 @@ export function RuntimeSensorRotateConfig() {
         {isLoading ? "⏳ Loading..." : "📥 Load Configuration"}
       </button>
 
+      <div className="button-group">
+        <button
+          className="btn btn-secondary"
+          disabled={isLoading}
+          onClick={exportConfig}
+        >
+          ⬇️ Download Backup
+        </button>
+        <button
+          className="btn btn-secondary"
+          disabled={isLoading}
+          onClick={() => importInput.current?.click()}
+        >
+          ⬆️ Restore Backup
+        </button>
+        <input
+          ref={importInput}
+          type="file"
+          accept=".rsr,application/octet-stream"
+          hidden
+          onChange={(e) => {
+            const file = e.target.files?.[0];
+            e.target.value = "";
+            if (file) {
+              importConfig(file);
+            }
+          }}
+        />
+      </div>
+
+      {hasUnsavedChanges && (
+        <div className="warning-message unsaved-changes">
+          <p>✏️ Changes are pending and will be saved to flash shortly.</p>
+          <div className="button-group">
+            <button
+              className="btn btn-primary"
+              disabled={isLoading}
+              onClick={() => saveOrDiscardChanges(false)}
+            >
+              💾 Save Now
+            </button>
+            <button
+              className="btn btn-secondary"
+              disabled={isLoading}
+              onClick={() => saveOrDiscardChanges(true)}
+            >
+              ↩️ Discard
+            </button>
+          </div>
+        </div>
+      )}
+
       {error && (
         <div className="error-message">
           <p>🚨 {error}</p>
@@ -334,6 +918,7 @@ export function RuntimeSensorRotateConfig() {
 
           {allLayerBindings[selectedLayer] && (
             <LayerBindingEditor
+              key={`${sensorIndex}-${channel}-${selectedLayer}`}
               layer={selectedLayer}
               bindings={allLayerBindings[selectedLayer]}
               behaviors={behaviors}
@@ -343,15 +928,134 @@ export function RuntimeSensorRotateConfig() {
           )}
         </div>
       )}
+
+      <div className="layer-config">
+        <h3>Live Events</h3>
+        {eventLogEnabled ? (
+          <>
+            <div className="button-group">
+              <button
+                className="btn btn-secondary"
+                onClick={() => setIsLive((live) => !live)}
+              >
+                {isLive ? "⏹ Stop" : "📈 Start Live View"}
+              </button>
+              {liveEvents.length > 0 && (
+                <button
+                  className="btn btn-secondary"
+                  onClick={() => {
+                    setLiveEvents([]);
+                    setDroppedEvents(0);
+                  }}
+                >
+                  🧹 Clear
+                </button>
+              )}
+            </div>
+            {isLive && <RotationEventPlot events={sensorEvents} />}
+            {droppedEvents > 0 && (
+              <p className="hint">
+                {droppedEvents} events were dropped before they could be read.
+              </p>
+            )}
+          </>
+        ) : (
+          <p className="hint">
+            Build the firmware with CONFIG_ZMK_RUNTIME_SENSOR_ROTATE_EVENT_LOG=y
+            to see the rotation events live.
+          </p>
+        )}
+      </div>
     </section>
   );
 }
 
+interface RotationEventPlotProps {
+  events: RotationEvent[];
+}
+
+// Triggers of each event as bars, CW up and CCW down, and the remainder of
+// the accumulator as a line, over the last few seconds
+function RotationEventPlot({ events }: RotationEventPlotProps) {
+  if (events.length === 0) {
+    return <p className="hint">Rotate the sensor to see its events.</p>;
+  }
+
+  const width = 600;
+  const height = 160;
+  const mid = height / 2;
+  const end = events[events.length - 1].timestampMs;
+  const visible = events.filter(
+    (event) => end - event.timestampMs <= PLOT_WINDOW_MS
+  );
+  const x = (timestampMs: number) =>
+    width - ((end - timestampMs) / PLOT_WINDOW_MS) * width;
+  const maxTriggers = Math.max(
+    1,
+    ...visible.map((event) => Math.abs(event.triggers))
+  );
+  const barScale = (mid - 4) / maxTriggers;
+  const last = events[events.length - 1];
+  const lastValue = `${last.val1}.${String(Math.abs(last.val2)).padStart(6, "0")}`;
+  const lastBinding = last.transparent
+    ? ", transparent"
+    : last.binding
+      ? `, behavior ${last.binding.behaviorId}`
+      : "";
+
+  return (
+    <div className="event-plot">
+      <svg
+        viewBox={`0 0 ${width} ${height}`}
+        role="img"
+        aria-label="Rotation events"
+      >
+        <line className="event-axis" x1={0} y1={mid} x2={width} y2={mid} />
+        {visible.map((event) => (
+          <rect
+            key={event.sequence}
+            className={
+              event.transparent
+                ? "event-transparent"
+                : event.triggers > 0
+                  ? "event-cw"
+                  : "event-ccw"
+            }
+            x={x(event.timestampMs) - 1}
+            y={event.triggers > 0 ? mid - event.triggers * barScale : mid}
+            width={2}
+            height={Math.max(1, Math.abs(event.triggers) * barScale)}
+          />
+        ))}
+        <polyline
+          className="event-remainder"
+          points={visible
+            .map(
+              (event) =>
+                `${x(event.timestampMs)},${mid - (event.remainderMilli / 1000) * (mid - 4)}`
+            )
+            .join(" ")}
+        />
+      </svg>
+      <p className="hint">
+        Last: layer {last.layer}, {lastValue}°, {last.triggers} triggers,
+        remainder {(last.remainderMilli / 1000).toFixed(3)}
+        {lastBinding}
+      </p>
+    </div>
+  );
+}
+
 interface LayerBindingEditorProps {
   layer: number;
   bindings: LayerBindings;
   behaviors: GetBehaviorDetailsResponse[];
-  onSave: (layer: number, cwBinding: Binding, ccwBinding: Binding) => void;
+  onSave: (
+    layer: number,
+    cwBinding: Binding,
+    ccwBinding: Binding,
+    acceleration: Acceleration
+  ) => void;
   isLoading: boolean;
 }
 
@@ -368,6 +1072,7 @@ function LayerBindingEditor({
   const [cwParam1, setCwParam1] = useState(bindings.cwBinding?.param1 || 0);
   const [cwParam2, setCwParam2] = useState(bindings.cwBinding?.param2 || 0);
   const [cwTapMs, setCwTapMs] = useState(bindings.cwBinding?.tapMs || 100);
+  const [cwHoldMs, setCwHoldMs] = useState(bindings.cwBinding?.holdMs || 0);
 
   const [ccwBehaviorId, setCcwBehaviorId] = useState(
     bindings.ccwBinding?.behaviorId || 0
@@ -375,6 +1080,17 @@ function LayerBindingEditor({
   const [ccwParam1, setCcwParam1] = useState(bindings.ccwBinding?.param1 || 0);
   const [ccwParam2, setCcwParam2] = useState(bindings.ccwBinding?.param2 || 0);
   const [ccwTapMs, setCcwTapMs] = useState(bindings.ccwBinding?.tapMs || 100);
+  const [ccwHoldMs, setCcwHoldMs] = useState(bindings.ccwBinding?.holdMs || 0);
+
+  const [accelThresholdMs, setAccelThresholdMs] = useState(
+    bindings.acceleration?.thresholdMs || 0
+  );
+  const [accelMultiplier, setAccelMultiplier] = useState(
+    bindings.acceleration?.multiplier || 100
+  );
+  const [accelMaxTriggers, setAccelMaxTriggers] = useState(
+    bindings.acceleration?.maxTriggers || 0
+  );
 
   const handleSave = () => {
     const cwBinding: Binding = {
@@ -382,6 +1098,7 @@ function LayerBindingEditor({
       param1: cwParam1,
       param2: cwParam2,
       tapMs: cwTapMs,
+      holdMs: cwHoldMs,
     };
 
     const ccwBinding: Binding = {
@@ -389,9 +1106,16 @@ function LayerBindingEditor({
       param1: ccwParam1,
       param2: ccwParam2,
       tapMs: ccwTapMs,
+      holdMs: ccwHoldMs,
+    };
+
+    const acceleration: Acceleration = {
+      thresholdMs: accelThresholdMs,
+      multiplier: accelMultiplier,
+      maxTriggers: accelMaxTriggers,
     };
 
-    onSave(layer, cwBinding, ccwBinding);
+    onSave(layer, cwBinding, ccwBinding, acceleration);
   };
 
   // Helper to get behavior name from ID
@@ -445,6 +1169,14 @@ function LayerBindingEditor({
             onChange={(e) => setCwTapMs(parseInt(e.target.value) || 100)}
           />
         </div>
+        <div className="input-group">
+          <label>Hold MS:</label>
+          <input
+            type="number"
+            value={cwHoldMs}
+            onChange={(e) => setCwHoldMs(parseInt(e.target.value) || 0)}
+          />
+        </div>
       </div>
 
       <div className="binding-group">
@@ -490,6 +1222,52 @@ function LayerBindingEditor({
             onChange={(e) => setCcwTapMs(parseInt(e.target.value) || 100)}
           />
         </div>
+        <div className="input-group">
+          <label>Hold MS:</label>
+          <input
+            type="number"
+            value={ccwHoldMs}
+            onChange={(e) => setCcwHoldMs(parseInt(e.target.value) || 0)}
+          />
+        </div>
+        <p className="hint">
+          Hold MS above 0 keeps the binding pressed while spinning and releases
+          it after that long without rotation.
+        </p>
+      </div>
+
+      <div className="binding-group">
+        <h5>⚡ Acceleration</h5>
+        <div className="input-group">
+          <label>Threshold MS:</label>
+          <input
+            type="number"
+            value={accelThresholdMs}
+            onChange={(e) => setAccelThresholdMs(parseInt(e.target.value) || 0)}
+          />
+        </div>
+        <div className="input-group">
+          <label>Multiplier %:</label>
+          <input
+            type="number"
+            value={accelMultiplier}
+            onChange={(e) =>
+              setAccelMultiplier(parseInt(e.target.value) || 100)
+            }
+          />
+        </div>
+        <div className="input-group">
+          <label>Max Triggers:</label>
+          <input
+            type="number"
+            value={accelMaxTriggers}
+            onChange={(e) => setAccelMaxTriggers(parseInt(e.target.value) || 0)}
+          />
+        </div>
+        <p className="hint">
+          Events closer than the threshold are scaled up to the multiplier.
+          Threshold 0 disables acceleration.
+        </p>
       </div>
 
       <button
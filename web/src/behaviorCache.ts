@@ -0,0 +1,154 @@
+/**
+ * Behavior details cache
+ * Fetches the details of the behaviors of a device with bounded concurrency
+ * and keeps them in localStorage, so that later sessions can show the binding
+ * editor without waiting for a request per behavior
+ */
+
+import { call_rpc } from "@zmkfirmware/zmk-studio-ts-client";
+import type { GetBehaviorDetailsResponse } from "@zmkfirmware/zmk-studio-ts-client/behaviors";
+
+type RpcConnection = Parameters<typeof call_rpc>[0];
+type BehaviorStorage = Pick<Storage, "getItem" | "setItem">;
+
+const CACHE_KEY_PREFIX = "rsr-behaviors:";
+// Bumped whenever the format of the cached entries changes
+const CACHE_VERSION = 2;
+// Requests in flight at a time. Over BLE, more only queue up in the transport.
+export const DEFAULT_CONCURRENCY = 4;
+// Age after which cached details are fetched again even if the behavior IDs
+// still match, see behaviorFingerprint
+export const DEFAULT_MAX_AGE_MS = 24 * 60 * 60 * 1000;
+
+interface CacheEntry {
+  version: number;
+  fingerprint: string;
+  fetchedAt: number;
+  behaviors: GetBehaviorDetailsResponse[];
+}
+
+export interface LoadBehaviorsOptions {
+  storage?: BehaviorStorage;
+  concurrency?: number;
+  maxAgeMs?: number;
+  now?: () => number;
+}
+
+// The behavior IDs of a firmware build. Any change to the behaviors of the
+// keymap changes the list, which invalidates the cached details. The IDs are
+// hashes of the behavior names, so a firmware update that only changes the
+// parameters of a behavior keeps them, and the details expire after maxAgeMs
+// instead.
+export function behaviorFingerprint(behaviorIds: number[]): string {
+  return [...behaviorIds].sort((a, b) => a - b).join(",");
+}
+
+function readEntry(
+  deviceKey: string,
+  storage: BehaviorStorage
+): CacheEntry | undefined {
+  try {
+    const raw = storage.getItem(CACHE_KEY_PREFIX + deviceKey);
+    const entry = raw ? (JSON.parse(raw) as CacheEntry) : undefined;
+    return entry?.version === CACHE_VERSION ? entry : undefined;
+  } catch {
+    return undefined;
+  }
+}
+
+// Details cached for the device by an earlier session, if any. Makes no
+// request, the caller revalidates them with loadBehaviors.
+export function readCachedBehaviors(
+  deviceKey: string,
+  storage: BehaviorStorage = localStorage
+): GetBehaviorDetailsResponse[] | undefined {
+  return readEntry(deviceKey, storage)?.behaviors;
+}
+
+// Like Promise.all over items.map(fn), with at most limit calls pending
+export async function mapWithConcurrency<T, R>(
+  items: T[],
+  limit: number,
+  fn: (item: T) => Promise<R>
+): Promise<R[]> {
+  const results: R[] = new Array(items.length);
+  let next = 0;
+  const worker = async () => {
+    while (next < items.length) {
+      const index = next++;
+      results[index] = await fn(items[index]);
+    }
+  };
+  await Promise.all(
+    Array.from({ length: Math.min(Math.max(limit, 1), items.length) }, worker)
+  );
+  return results;
+}
+
+// List the behaviors of the device and fetch the details of those not cached
+// for the same behavior list within maxAgeMs. A cache hit costs the list
+// request only.
+export async function loadBehaviors(
+  conn: RpcConnection,
+  deviceKey: string,
+  {
+    storage = localStorage,
+    concurrency = DEFAULT_CONCURRENCY,
+    maxAgeMs = DEFAULT_MAX_AGE_MS,
+    now = Date.now,
+  }: LoadBehaviorsOptions = {}
+): Promise<GetBehaviorDetailsResponse[]> {
+  const res = await call_rpc(conn, {
+    behaviors: {
+      listAllBehaviors: true,
+    },
+  });
+  if (res && res.meta) {
+    throw new Error(`Error: ${res.meta}`);
+  }
+  const behaviorIds = res?.behaviors?.listAllBehaviors?.behaviors ?? [];
+  const fingerprint = behaviorFingerprint(behaviorIds);
+
+  const cached = readEntry(deviceKey, storage);
+  if (
+    cached?.fingerprint === fingerprint &&
+    now() - cached.fetchedAt < maxAgeMs
+  ) {
+    return cached.behaviors;
+  }
+
+  const details = await mapWithConcurrency(
+    behaviorIds,
+    concurrency,
+    async (behaviorId) => {
+      const detailRes = await call_rpc(conn, {
+        behaviors: {
+          getBehaviorDetails: {
+            behaviorId,
+          },
+        },
+      });
+      return detailRes?.behaviors?.getBehaviorDetails;
+    }
+  );
+  const behaviors = details.filter((b) => b !== undefined);
+
+  // Only complete lists are cached, a failed request is retried next time
+  if (behaviors.length === behaviorIds.length) {
+    try {
+      storage.setItem(
+        CACHE_KEY_PREFIX + deviceKey,
+        JSON.stringify({
+          version: CACHE_VERSION,
+          fingerprint,
+          fetchedAt: now(),
+          behaviors,
+        } satisfies CacheEntry)
+      );
+    } catch (err) {
+      // Quota exceeded or storage disabled, the details are just not cached
+      console.warn("Failed to cache behavior details:", err);
+    }
+  }
+  return behaviors;
+}
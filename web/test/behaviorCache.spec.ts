@@ -0,0 +1,150 @@
+/**
+ * Tests for the behavior details cache
+ */
+
+import { call_rpc } from "@zmkfirmware/zmk-studio-ts-client";
+import {
+  loadBehaviors,
+  mapWithConcurrency,
+  readCachedBehaviors,
+} from "../src/behaviorCache";
+
+jest.mock("@zmkfirmware/zmk-studio-ts-client", () => ({
+  call_rpc: jest.fn(),
+}));
+
+const mockCallRpc = call_rpc as jest.Mock;
+const conn = {} as Parameters<typeof loadBehaviors>[0];
+
+// Answer the behavior requests of a device with the given behavior IDs
+function mockDevice(behaviorIds: number[], displayNamePrefix = "Behavior") {
+  mockCallRpc.mockImplementation(async (_conn, request) => {
+    if (request.behaviors?.listAllBehaviors) {
+      return { behaviors: { listAllBehaviors: { behaviors: behaviorIds } } };
+    }
+    const behaviorId = request.behaviors?.getBehaviorDetails?.behaviorId;
+    return {
+      behaviors: {
+        getBehaviorDetails: {
+          id: behaviorId,
+          displayName: `${displayNamePrefix} ${behaviorId}`,
+          metadata: [],
+        },
+      },
+    };
+  });
+}
+
+function detailRequests() {
+  return mockCallRpc.mock.calls.filter(
+    ([, request]) => request.behaviors?.getBehaviorDetails
+  );
+}
+
+describe("behaviorCache", () => {
+  beforeEach(() => {
+    localStorage.clear();
+    mockCallRpc.mockReset();
+  });
+
+  it("should fetch the details of each behavior once and cache them", async () => {
+    mockDevice([1, 2, 3]);
+
+    const behaviors = await loadBehaviors(conn, "keyboard");
+
+    expect(behaviors.map((b) => b.displayName)).toEqual([
+      "Behavior 1",
+      "Behavior 2",
+      "Behavior 3",
+    ]);
+    expect(detailRequests()).toHaveLength(3);
+    expect(readCachedBehaviors("keyboard")).toEqual(behaviors);
+  });
+
+  it("should make no detail requests on a cache hit", async () => {
+    mockDevice([1, 2, 3]);
+    const first = await loadBehaviors(conn, "keyboard");
+    mockCallRpc.mockClear();
+
+    // Shown before any request is made
+    expect(readCachedBehaviors("keyboard")).toEqual(first);
+    expect(mockCallRpc).not.toHaveBeenCalled();
+
+    // Revalidation only lists the behaviors
+    const second = await loadBehaviors(conn, "keyboard");
+    expect(second).toEqual(first);
+    expect(mockCallRpc).toHaveBeenCalledTimes(1);
+    expect(detailRequests()).toHaveLength(0);
+  });
+
+  it("should refetch when the behaviors of the device change", async () => {
+    mockDevice([1, 2]);
+    await loadBehaviors(conn, "keyboard");
+    mockDevice([1, 2, 4]);
+    mockCallRpc.mockClear();
+
+    const behaviors = await loadBehaviors(conn, "keyboard");
+
+    expect(behaviors).toHaveLength(3);
+    expect(detailRequests()).toHaveLength(3);
+  });
+
+  it("should refetch details that changed under the same IDs once they expire", async () => {
+    let time = 0;
+    const now = () => time;
+    mockDevice([1, 2]);
+    await loadBehaviors(conn, "keyboard", { now, maxAgeMs: 1000 });
+
+    // A firmware update changes the details but keeps the IDs, which are
+    // hashes of the behavior names
+    mockDevice([1, 2], "Updated");
+    mockCallRpc.mockClear();
+
+    time = 999;
+    const cached = await loadBehaviors(conn, "keyboard", {
+      now,
+      maxAgeMs: 1000,
+    });
+    expect(cached[0].displayName).toBe("Behavior 1");
+    expect(detailRequests()).toHaveLength(0);
+
+    time = 1000;
+    const refetched = await loadBehaviors(conn, "keyboard", {
+      now,
+      maxAgeMs: 1000,
+    });
+    expect(refetched.map((b) => b.displayName)).toEqual([
+      "Updated 1",
+      "Updated 2",
+    ]);
+    expect(detailRequests()).toHaveLength(2);
+    expect(readCachedBehaviors("keyboard")).toEqual(refetched);
+  });
+
+  it("should keep devices apart", async () => {
+    mockDevice([1]);
+    await loadBehaviors(conn, "keyboard");
+
+    expect(readCachedBehaviors("other keyboard")).toBeUndefined();
+  });
+
+  it("should bound the requests in flight", async () => {
+    let inFlight = 0;
+    let maxInFlight = 0;
+
+    const results = await mapWithConcurrency(
+      Array.from({ length: 10 }, (_, i) => i),
+      3,
+      async (i) => {
+        inFlight++;
+        maxInFlight = Math.max(maxInFlight, inFlight);
+        await new Promise((resolve) => setTimeout(resolve, 1));
+        inFlight--;
+        return i * 2;
+      }
+    );
+
+    expect(results).toEqual([0, 2, 4, 6, 8, 10, 12, 14, 16, 18]);
+    expect(maxInFlight).toBe(3);
+  });
+});